@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdio>
+
+#include <blocs/common.h>
+#include <blocs/time.h>
+
+/**
+ * @brief Runs a function repeatedly and prints the average time of a run.
+ *
+ * @param name Label printed with the result.
+ * @param runs Number of timed runs, after one untimed warm up run.
+ * @param func Work to measure.
+ *
+ * @return Average time of a run in milliseconds.
+ */
+template<typename Func>
+inline blocs::f64 measure(const char* name, blocs::u32 runs, Func&& func)
+{
+    func();
+
+    blocs::Stopwatch watch;
+    for (blocs::u32 i = 0; i < runs; i++) func();
+    watch.stop();
+
+    blocs::f64 ms = watch.get_time_elapsed_ms() / runs;
+    std::printf("%-40s %10.4f ms\n", name, ms);
+    return ms;
+}
+
+/**
+ * Results are added to this so the compiler cannot optimize away the work
+ * that produced them.
+ */
+inline volatile blocs::f64 sink = 0;
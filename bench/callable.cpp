@@ -0,0 +1,57 @@
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+
+#include "bench.h"
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Velocity
+{
+    f32 x, y;
+};
+
+constexpr u32 ENTITIES = 1000000;
+constexpr u32 RUNS     = 50;
+
+int main()
+{
+    World world;
+    for (u32 i = 0; i < ENTITIES; i++)
+    {
+        Entity entity = world.spawn_entity();
+        world.add_component<Position>(entity, (f32)i, 0.0f);
+        world.add_component<Velocity>(entity, 1.0f, 0.5f);
+    }
+
+    auto step = [](Position& position, Velocity& velocity)
+    {
+        position.x += velocity.x;
+        position.y += velocity.y;
+    };
+
+    // How every query was called before callables were template parameters
+    Query<Position, Velocity> erased = step;
+
+    f64 inlined = measure(
+        "query, lambda", RUNS,
+        [&]() { world.query<Position, Velocity>(step); }
+    );
+    f64 function = measure(
+        "query, std::function", RUNS,
+        [&]() { world.query<Position, Velocity>(erased); }
+    );
+
+    std::printf(
+        "%-40s %10.4f ns\n", "per entity, lambda", inlined * 1e6 / ENTITIES
+    );
+    std::printf(
+        "%-40s %10.4f ns\n", "per entity, std::function",
+        function * 1e6 / ENTITIES
+    );
+}
@@ -0,0 +1,89 @@
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+
+#include "bench.h"
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Velocity
+{
+    f32 x, y;
+};
+
+constexpr u32 RUNS = 5;
+
+void run(u32 count)
+{
+    std::printf("%u entities\n", count);
+
+    std::vector<Position> positions(count, Position{0.0f, 0.0f});
+    std::vector<Velocity> velocities(count, Velocity{1.0f, 0.5f});
+
+    measure(
+        "  spawn one by one", RUNS,
+        [&]()
+        {
+            World world;
+            for (u32 i = 0; i < count; i++)
+            {
+                Entity entity = world.spawn_entity();
+                world.add_component<Position>(entity, 0.0f, 0.0f);
+                world.add_component<Velocity>(entity, 1.0f, 0.5f);
+            }
+        }
+    );
+
+    measure(
+        "  spawn in a batch", RUNS,
+        [&]()
+        {
+            World world;
+            auto  entities = world.spawn_batch(count);
+            world.components.insert_batch<Position>(entities, positions);
+            world.components.insert_batch<Velocity>(entities, velocities);
+        }
+    );
+
+    World world;
+    auto  entities = world.spawn_batch(count);
+    world.components.insert_batch<Position>(entities, positions);
+    world.components.insert_batch<Velocity>(entities, velocities);
+
+    measure(
+        "  query", RUNS,
+        [&]()
+        {
+            world.query<Position, const Velocity>(
+                [](Position& position, const Velocity& velocity)
+                {
+                    position.x += velocity.x;
+                    position.y += velocity.y;
+                }
+            );
+        }
+    );
+
+    measure(
+        "  destroy and respawn", RUNS,
+        [&]()
+        {
+            for (Entity entity : entities) world.destroy_entity(entity);
+            entities = world.spawn_batch(count);
+            world.components.insert_batch<Position>(entities, positions);
+            world.components.insert_batch<Velocity>(entities, velocities);
+        }
+    );
+}
+
+int main()
+{
+    for (u32 count : {10000u, 100000u, 1000000u}) run(count);
+}
@@ -0,0 +1,77 @@
+#include <cmath>
+#include <thread>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+
+#include "bench.h"
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Velocity
+{
+    f32 x, y;
+};
+
+constexpr u32 ENTITIES = 200000;
+constexpr u32 RUNS     = 20;
+
+int main()
+{
+    World world;
+    for (u32 i = 0; i < ENTITIES; i++)
+    {
+        Entity entity = world.spawn_entity();
+        world.add_component<Position>(entity, (f32)i, 0.0f);
+        world.add_component<Velocity>(entity, 1.0f, 0.5f);
+    }
+
+    // Enough work per entity for the cost of the jobs to be amortized
+    auto step = [](Position& position, const Velocity& velocity)
+    {
+        for (i32 i = 0; i < 16; i++)
+        {
+            position.x = std::sin(position.x) + velocity.x;
+            position.y = std::cos(position.y) + velocity.y;
+        }
+    };
+
+    f64 single = measure(
+        "query", RUNS,
+        [&]()
+        {
+            world.query<Position, Velocity>(
+                [&](Position& position, Velocity& velocity)
+                { step(position, velocity); }
+            );
+        }
+    );
+
+    size cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size threads = 1; threads <= cores; threads++)
+    {
+        // The calling thread runs jobs too, so one less worker is needed
+        world.jobs.set_workers(threads - 1);
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "par_query, %zu threads", threads);
+
+        f64 ms = measure(
+            label, RUNS,
+            [&]()
+            {
+                world.par_query<Position, Velocity>(
+                    [&](Position& position, Velocity& velocity)
+                    { step(position, velocity); }
+                );
+            }
+        );
+        std::printf("%-40s %10.2fx\n", "  speedup", single / ms);
+    }
+}
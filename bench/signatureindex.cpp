@@ -0,0 +1,104 @@
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+
+#include "bench.h"
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Velocity
+{
+    f32 x, y;
+};
+
+struct Mass
+{
+    f32 value;
+};
+
+template<u32 N>
+struct Tag
+{
+};
+
+constexpr u32 ENTITIES = 100000;
+constexpr u32 RUNS     = 50;
+
+/**
+ * @brief Fills a world where every entity has a position and velocity, one
+ * in ten has a mass, and tags split them over 16 signatures.
+ */
+void populate(World& world)
+{
+    for (u32 i = 0; i < ENTITIES; i++)
+    {
+        Entity entity = world.spawn_entity();
+        world.add_component<Position>(entity, (f32)i, 0.0f);
+        world.add_component<Velocity>(entity, 1.0f, 1.0f);
+        if (i % 10 == 0) world.add_component<Mass>(entity, 2.0f);
+
+        if (i & 1) world.add_component<Tag<0>>(entity);
+        if (i & 2) world.add_component<Tag<1>>(entity);
+        if (i & 4) world.add_component<Tag<2>>(entity);
+        if (i & 8) world.add_component<Tag<3>>(entity);
+    }
+}
+
+void run(const char* label, Storage storage)
+{
+    World world(storage);
+    populate(world);
+
+    std::printf("%s\n", label);
+
+    measure(
+        "  each<Position, Velocity>", RUNS,
+        [&]()
+        {
+            world.each<Position, Velocity>(
+                [](Entity, Position& position, Velocity& velocity)
+                {
+                    position.x += velocity.x;
+                    position.y += velocity.y;
+                }
+            );
+        }
+    );
+
+    measure(
+        "  each<Position, Velocity, Mass>", RUNS,
+        [&]()
+        {
+            f32 total = 0;
+            world.each<Position, Velocity, Mass>(
+                [&](Entity, Position& position, Velocity&, Mass& mass)
+                { total += position.x * mass.value; }
+            );
+            sink = sink + total;
+        }
+    );
+
+    measure(
+        "  each<Position, Tag<0>, Tag<3>>", RUNS,
+        [&]()
+        {
+            f32 total = 0;
+            world.each<Position, Tag<0>, Tag<3>>(
+                [&](Entity, Position& position, Tag<0>&, Tag<3>&)
+                { total += position.x; }
+            );
+            sink = sink + total;
+        }
+    );
+}
+
+int main()
+{
+    run("sparse set", Storage::SPARSE_SET);
+    run("signature index", Storage::SIGNATURE_INDEX);
+}
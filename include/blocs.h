@@ -13,10 +13,18 @@
 #include "blocs/ecs/components/component.h"
 #include "blocs/ecs/components/componentarray.h"
 #include "blocs/ecs/components/componentmanager.h"
+#include "blocs/ecs/signatures/signaturebucket.h"
+#include "blocs/ecs/signatures/signatureindex.h"
+#include "blocs/ecs/commands/commandbuffer.h"
+#include "blocs/ecs/queries/querycache.h"
+#include "blocs/ecs/queries/cachedquery.h"
 #include "blocs/ecs/systems/system.h"
 #include "blocs/ecs/systems/systemmanager.h"
 #include "blocs/ecs/resources/resource.h"
 #include "blocs/ecs/resources/resourcemanager.h"
+#include "blocs/ecs/resources/spatialhash.h"
+#include "blocs/ecs/hierarchy.h"
+#include "blocs/ecs/binary.h"
 
 #include "blocs/graphics/renderer.h"
 #include "blocs/graphics/font.h"
@@ -41,3 +49,4 @@
 #include "blocs/common.h"
 #include "blocs/game.h"
 #include "blocs/time.h"
+#include "blocs/jobs.h"
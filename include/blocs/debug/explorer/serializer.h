@@ -67,6 +67,7 @@
     }
 
 #include <string_view>
+#include <type_traits>
 
 #include <blocs/ecs/world.h>
 
@@ -74,27 +75,41 @@ namespace blocs
 {
     namespace serializer
     {
+        /** @return Compiler generated signature naming type T. */
         template<typename T>
-        constexpr auto type_name()
+        constexpr std::string_view type_signature()
         {
-            std::string_view name, prefix, suffix;
-#ifdef __clang__
-            name   = __PRETTY_FUNCTION__;
-            prefix = "auto blocs::serializer::type_name() [T = const ";
-            suffix = " &]";
-#elif defined(__GNUC__)
-            name = __PRETTY_FUNCTION__;
-            prefix =
-                "constexpr auto blocs::serializer::type_name() [with T = "
-                "const ";
-            suffix = " &]";
-#elif defined(_MSC_VER)
-            name   = __FUNCSIG__;
-            prefix = "auto __cdecl blocs::serializer::type_name<const ";
-            suffix = " &>(void)";
+#ifdef _MSC_VER
+            return __FUNCSIG__;
+#else
+            return __PRETTY_FUNCTION__;
 #endif
-            name.remove_prefix(prefix.size());
-            name.remove_suffix(suffix.size());
+        }
+
+        /**
+         * @return Name of type T without const, volatile or references, cut
+         * out of its signature. The prefix and suffix around the name are
+         * measured on a known type, so the result is the same on Clang, GCC
+         * and MSVC apart from how each spells nested template arguments.
+         */
+        template<typename T>
+        constexpr std::string_view type_name()
+        {
+            constexpr std::string_view probe  = type_signature<double>();
+            constexpr size             prefix = probe.find("double");
+            constexpr size             suffix =
+                probe.size() - prefix - std::string_view("double").size();
+
+            std::string_view name = type_signature<std::remove_cvref_t<T>>();
+            name.remove_prefix(prefix);
+            name.remove_suffix(suffix);
+
+            // MSVC names class types with their keyword
+            for (std::string_view keyword : {"struct ", "class ", "enum "})
+            {
+                if (name.starts_with(keyword))
+                    name.remove_prefix(keyword.size());
+            }
             return name;
         }
 
@@ -478,7 +493,8 @@ namespace blocs
                 }
 
                 inline void serialize_names_to_json(
-                    ss& stream, std::unordered_map<ecs::Entity, str>& names
+                    ss&                                         stream,
+                    const std::unordered_map<ecs::Entity, str>& names
                 )
                 {
                     open_object(stream);
@@ -574,7 +590,8 @@ namespace blocs
                 return stream.str();
             }
 
-            inline str names_to_json(std::unordered_map<ecs::Entity, str>& names
+            inline str names_to_json(
+                const std::unordered_map<ecs::Entity, str>& names
             )
             {
                 ss stream;
@@ -1,6 +1,11 @@
 #pragma once
 
 #ifdef DEBUG
+#include <cstring>
+#include <sstream>
+
+#include <blocs/common.h>
+
 #define PRINT_TEST_ARG_(NAME) #NAME
 #define PRINT_TEST_ARG(NAME)  PRINT_TEST_ARG_(NAME)
 
@@ -37,6 +42,8 @@
         ss << "\tpass:\t" << GRN(passes) << "\n";                        \
         ss << "\tfail:\t" << RED(fails);                                 \
                                                                          \
+        blocs::debug::test::failures() += fails;                         \
+                                                                         \
         std::cout << (fails == 0 ? "\x1B[42m PASS \x1B[0m"               \
                                  : "\x1B[41m FAIL \x1B[0m")              \
                   << " " << BOLD(__FILENAME__) << "\n"                   \
@@ -66,6 +73,13 @@ namespace blocs
                 bool passed;
             };
 
+            /** @return Number of failed expectations, for an exit code. */
+            inline int& failures()
+            {
+                static int s_failures = 0;
+                return s_failures;
+            }
+
             template<typename T>
             test_result compare(
                 const str& describe, T a, T b, str a_str, str b_str
@@ -0,0 +1,639 @@
+#pragma once
+
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/platform/filesystem.h>
+#include <blocs/debug/explorer/serializer.h>
+
+namespace blocs
+{
+    namespace serializer
+    {
+        /**
+         * Versioned binary world format. A file holds a header, a table of
+         * blocks, then the blocks themselves, each aligned to `ALIGNMENT`:
+         *
+         * - the entity slots, copied as is,
+         * - the entity names,
+         * - one block per component type, holding the owning entities and
+         *   then the components. Trivially copyable components are stored
+         *   as a raw column that is read straight out of a mapped file.
+         *   Other components are written field by field through their
+         *   `Blueprint`.
+         */
+        namespace binary
+        {
+            /** "BLCS" read as a little endian u32. */
+            constexpr u32  MAGIC     = 0x53434C42;
+            constexpr u32  VERSION   = 1;
+            constexpr size ALIGNMENT = 16;
+
+            enum class Format : u32
+            {
+                /** Components copied as raw bytes. */
+                RAW,
+                /** Components written field by field from their Blueprint. */
+                FIELDS,
+            };
+
+            struct FileHeader
+            {
+                u32 magic;
+                u32 version;
+                /** Number of entity slots and offset of the slot block. */
+                u64 slots;
+                u64 slots_offset;
+                /** Offset and length of the entity name block. */
+                u64 names_offset;
+                u64 names_bytes;
+                u64 active;
+                u32 free_list;
+                /** Number of component blocks following the header. */
+                u32 blocks;
+            };
+
+            struct BlockHeader
+            {
+                /** Hash of the component's type name. */
+                u64    id;
+                /** Number of components. */
+                u64    count;
+                /** Offset of the owning entities. */
+                u64    entities;
+                /** Offset and length of the component data. */
+                u64    data;
+                u64    bytes;
+                /** Size of one component, checked for raw blocks. */
+                u32    stride;
+                Format format;
+            };
+
+            /**
+             * @return Stable id of a component type: the FNV-1a hash of its
+             * `type_name`.
+             */
+            template<typename T>
+            constexpr u64 type_id()
+            {
+                u64 hash = 0xCBF29CE484222325;
+                for (char c : type_name<T>())
+                {
+                    hash ^= (u8)c;
+                    hash *= 0x100000001B3;
+                }
+                return hash;
+            }
+
+            namespace
+            {
+                /** @brief Bounds checked cursor over loaded bytes. */
+                struct Reader
+                {
+                    const u8* data;
+                    size      len;
+                    size      pos = 0;
+
+                    bool read(void* out, size bytes)
+                    {
+                        if (pos + bytes > len) return false;
+
+                        std::memcpy(out, data + pos, bytes);
+                        pos += bytes;
+                        return true;
+                    }
+                };
+
+                inline void align(std::vector<u8>& out)
+                {
+                    out.resize((out.size() + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+                }
+
+                inline void append(
+                    std::vector<u8>& out, const void* data, size bytes
+                )
+                {
+                    const u8* begin = (const u8*)data;
+                    out.insert(out.end(), begin, begin + bytes);
+                }
+
+                template<typename T>
+                inline void write_value(std::vector<u8>& out, const T& value);
+
+                template<typename T>
+                inline bool read_value(Reader& in, T& value);
+
+                inline void write_value(std::vector<u8>& out, const str& value)
+                {
+                    u64 len = value.size();
+                    append(out, &len, sizeof(u64));
+                    append(out, value.data(), len);
+                }
+
+                inline bool read_value(Reader& in, str& value)
+                {
+                    u64 len;
+                    if (!in.read(&len, sizeof(u64)) || len > in.len - in.pos)
+                        return false;
+
+                    value.assign((const char*)in.data + in.pos, len);
+                    in.pos += len;
+                    return true;
+                }
+
+                template<typename T>
+                inline void write_value(
+                    std::vector<u8>& out, const std::vector<T>& values
+                )
+                {
+                    u64 count = values.size();
+                    append(out, &count, sizeof(u64));
+                    for (const auto& value : values) write_value(out, value);
+                }
+
+                template<typename T>
+                inline bool read_value(Reader& in, std::vector<T>& values)
+                {
+                    u64 count;
+                    if (!in.read(&count, sizeof(u64))) return false;
+                    if (count > in.len - in.pos) return false;
+
+                    values.resize(count);
+                    for (auto& value : values)
+                    {
+                        if (!read_value(in, value)) return false;
+                    }
+                    return true;
+                }
+
+                template<typename T, typename Fields, std::size_t... Seq>
+                inline void write_fields(
+                    std::vector<u8>& out, const T& object,
+                    const Fields& fields, std::index_sequence<Seq...> const&
+                )
+                {
+                    (write_value(out, object.*(std::get<Seq>(fields).second)),
+                     ...);
+                }
+
+                template<typename T, typename Fields, std::size_t... Seq>
+                inline bool read_fields(
+                    Reader& in, T& object, const Fields& fields,
+                    std::index_sequence<Seq...> const&
+                )
+                {
+                    return (
+                        read_value(
+                            in, object.*(std::get<Seq>(fields).second)
+                        ) &&
+                        ...
+                    );
+                }
+
+                template<typename T>
+                inline void write_value(std::vector<u8>& out, const T& value)
+                {
+                    if constexpr (std::is_trivially_copyable_v<T>)
+                        append(out, &value, sizeof(T));
+                    else
+                    {
+                        using Fields = typename Blueprint<T>::Fields;
+                        write_fields(
+                            out, value, Blueprint<T>::get_fields(),
+                            std::make_index_sequence<
+                                std::tuple_size<Fields>::value>()
+                        );
+                    }
+                }
+
+                template<typename T>
+                inline bool read_value(Reader& in, T& value)
+                {
+                    if constexpr (std::is_trivially_copyable_v<T>)
+                        return in.read(&value, sizeof(T));
+                    else
+                    {
+                        using Fields = typename Blueprint<T>::Fields;
+                        return read_fields(
+                            in, value, Blueprint<T>::get_fields(),
+                            std::make_index_sequence<
+                                std::tuple_size<Fields>::value>()
+                        );
+                    }
+                }
+
+                /** Whether components of type T are stored as a raw column. */
+                template<typename T>
+                constexpr bool is_raw()
+                {
+                    return std::is_trivially_copyable_v<T> &&
+                           alignof(T) <= ALIGNMENT;
+                }
+
+                template<typename T>
+                inline void write_block(
+                    std::vector<u8>& out, BlockHeader& header, ecs::World& world
+                )
+                {
+                    auto* array = world.components.get_components<T>();
+                    auto  count = array->size();
+
+                    header.id     = type_id<T>();
+                    header.count  = count;
+                    header.stride = sizeof(T);
+                    header.format = is_raw<T>() ? Format::RAW : Format::FIELDS;
+
+                    align(out);
+                    header.entities = out.size();
+                    append(
+                        out, array->set.dense.data(),
+                        count * sizeof(ecs::Entity)
+                    );
+
+                    align(out);
+                    header.data = out.size();
+                    if constexpr (ecs::ComponentArray<T>::TAG)
+                    {
+                    }
+                    else if constexpr (is_raw<T>())
+                        append(
+                            out, array->components.data(), count * sizeof(T)
+                        );
+                    else
+                    {
+                        for (const auto& component : array->components)
+                            write_value(out, component);
+                    }
+                    header.bytes = out.size() - header.data;
+                }
+
+                /**
+                 * Whether `count` items of `stride` bytes starting at `offset`
+                 * lie within `len` bytes, without overflowing.
+                 */
+                inline bool fits(u64 offset, u64 count, u64 stride, size len)
+                {
+                    return offset <= len && count <= (len - offset) / stride;
+                }
+
+                /** Whether an entity is alive in a file's entity slots. */
+                inline bool alive_in(
+                    std::span<const ecs::Entity> slots, ecs::Entity entity
+                )
+                {
+                    ecs::EntityIndex index = ecs::get_index(entity);
+                    return index < slots.size() && slots[index] == entity;
+                }
+
+                /**
+                 * Checks that a file's entity slots form a valid entity
+                 * manager: the free list stays within the slots and has no
+                 * cycle, every other slot holds a live entity, and `active`
+                 * counts them.
+                 */
+                inline bool check_slots(
+                    std::span<const ecs::Entity> slots, u32 free_list,
+                    u64 active
+                )
+                {
+                    std::vector<bool> free(slots.size(), false);
+                    u32               index = free_list;
+                    while (index != ecs::NULL_INDEX)
+                    {
+                        if (index >= slots.size() || free[index]) return false;
+
+                        free[index] = true;
+                        index       = ecs::get_index(slots[index]);
+                    }
+
+                    u64 live = 0;
+                    for (u64 i = 0; i < slots.size(); i++)
+                    {
+                        if (free[i]) continue;
+                        if (ecs::get_index(slots[i]) != i) return false;
+                        live++;
+                    }
+                    return live == active;
+                }
+
+                /**
+                 * Checks a block against the type it is read as and decodes
+                 * field by field components, without touching the world.
+                 * Every entity of the block must be alive and appear once.
+                 *
+                 * @param seen One flag per slot, all false. Left all false.
+                 */
+                template<typename T>
+                inline bool check_block(
+                    const u8* data, size len,
+                    std::span<const ecs::Entity> slots, std::vector<bool>& seen,
+                    const BlockHeader& header, std::vector<T>& components
+                )
+                {
+                    if (header.entities % ALIGNMENT != 0 ||
+                        header.data % ALIGNMENT != 0 ||
+                        !fits(
+                            header.entities, header.count, sizeof(ecs::Entity),
+                            len
+                        ) ||
+                        !fits(header.data, header.bytes, 1, len))
+                        return false;
+
+                    const ecs::Entity* entities =
+                        (const ecs::Entity*)(data + header.entities);
+                    u64 checked = 0;
+                    while (checked < header.count)
+                    {
+                        ecs::Entity entity = entities[checked];
+                        if (!alive_in(slots, entity) ||
+                            seen[ecs::get_index(entity)])
+                            break;
+
+                        seen[ecs::get_index(entity)] = true;
+                        checked++;
+                    }
+                    for (u64 i = 0; i < checked; i++)
+                        seen[ecs::get_index(entities[i])] = false;
+                    if (checked < header.count) return false;
+
+                    if constexpr (ecs::ComponentArray<T>::TAG)
+                        return true;
+                    else if constexpr (is_raw<T>())
+                    {
+                        return header.format == Format::RAW &&
+                               header.stride == sizeof(T) &&
+                               fits(
+                                   header.data, header.count, sizeof(T), len
+                               ) &&
+                               header.bytes == header.count * sizeof(T);
+                    }
+                    else
+                    {
+                        // Every component takes at least one byte
+                        if (header.format != Format::FIELDS ||
+                            header.count > header.bytes)
+                            return false;
+
+                        Reader in{data + header.data, header.bytes};
+                        components.resize(header.count);
+                        for (auto& component : components)
+                        {
+                            if (!read_value(in, component)) return false;
+                        }
+                        return true;
+                    }
+                }
+
+                /** Inserts the components of a checked block. */
+                template<typename T>
+                inline void load_block(
+                    const u8* data, const BlockHeader& header,
+                    const std::vector<T>& components, ecs::World& world
+                )
+                {
+                    std::span<const ecs::Entity> entities(
+                        (const ecs::Entity*)(data + header.entities),
+                        header.count
+                    );
+
+                    if constexpr (ecs::ComponentArray<T>::TAG)
+                    {
+                        world.components.insert_batch<T>(
+                            entities, std::span<const T>()
+                        );
+                    }
+                    else if constexpr (is_raw<T>())
+                    {
+                        // Inserted straight from the loaded bytes
+                        world.components.insert_batch<T>(
+                            entities,
+                            std::span<const T>(
+                                (const T*)(data + header.data), header.count
+                            )
+                        );
+                    }
+                    else
+                    {
+                        world.components.insert_batch<T>(
+                            entities, std::span<const T>(components)
+                        );
+                    }
+                }
+
+                inline const BlockHeader* find_block(
+                    const BlockHeader* blocks, u32 count, u64 id
+                )
+                {
+                    for (u32 i = 0; i < count; i++)
+                    {
+                        if (blocks[i].id == id) return &blocks[i];
+                    }
+                    return nullptr;
+                }
+            }
+
+            /**
+             * @brief Writes a world's entities and the components of the given
+             * types into the binary format.
+             *
+             * @tparam Types types of components to write.
+             * @param world World to write.
+             *
+             * @return Bytes of the file.
+             */
+            template<typename... Types>
+            inline std::vector<u8> serialize(ecs::World& world)
+            {
+                constexpr u32 BLOCKS = sizeof...(Types);
+
+                std::vector<u8> out(
+                    sizeof(FileHeader) + BLOCKS * sizeof(BlockHeader)
+                );
+
+                FileHeader header{};
+                header.magic     = MAGIC;
+                header.version   = VERSION;
+                header.slots     = world.entities.slots.size();
+                header.active    = world.entities.num_active_entities;
+                header.free_list = world.entities.free_list;
+                header.blocks    = BLOCKS;
+
+                align(out);
+                header.slots_offset = out.size();
+                append(
+                    out, world.entities.slots.data(),
+                    header.slots * sizeof(ecs::Entity)
+                );
+
+                align(out);
+                header.names_offset = out.size();
+                for (const auto& [entity, name] : world.entities.entity_to_name)
+                {
+                    append(out, &entity, sizeof(ecs::Entity));
+                    write_value(out, name);
+                }
+                header.names_bytes = out.size() - header.names_offset;
+
+                BlockHeader blocks[BLOCKS > 0 ? BLOCKS : 1]{};
+                u32         next = 0;
+                ((write_block<Types>(out, blocks[next++], world)), ...);
+
+                std::memcpy(out.data(), &header, sizeof(FileHeader));
+                std::memcpy(
+                    out.data() + sizeof(FileHeader), blocks,
+                    BLOCKS * sizeof(BlockHeader)
+                );
+                return out;
+            }
+
+            /**
+             * @brief Replaces a world's entities and components with ones read
+             * from the binary format. Component types without a block in the
+             * data are left empty. The whole file is checked before the world
+             * is reset, so the world is left as it was when the data is
+             * invalid.
+             *
+             * @tparam Types types of components to read.
+             * @param world World to load into.
+             * @param data Bytes of the file, aligned to at least `ALIGNMENT`.
+             * @param len Number of bytes.
+             *
+             * @return Whether the data was a valid file.
+             */
+            template<typename... Types>
+            inline bool deserialize(ecs::World& world, const u8* data, size len)
+            {
+                constexpr u32 TYPES = sizeof...(Types);
+
+                FileHeader header;
+                if (len < sizeof(FileHeader)) return false;
+                std::memcpy(&header, data, sizeof(FileHeader));
+
+                if (header.magic != MAGIC || header.version != VERSION)
+                    return false;
+
+                size table = sizeof(FileHeader);
+                if (!fits(table, header.blocks, sizeof(BlockHeader), len) ||
+                    header.slots_offset % ALIGNMENT != 0 ||
+                    !fits(
+                        header.slots_offset, header.slots, sizeof(ecs::Entity),
+                        len
+                    ) ||
+                    !fits(header.names_offset, header.names_bytes, 1, len) ||
+                    header.slots > world.entities.capacity ||
+                    header.active > header.slots)
+                    return false;
+
+                std::span<const ecs::Entity> slots(
+                    (const ecs::Entity*)(data + header.slots_offset),
+                    header.slots
+                );
+                if (!check_slots(slots, header.free_list, header.active))
+                    return false;
+
+                std::vector<std::pair<ecs::Entity, str>> names;
+                Reader names_in{data + header.names_offset, header.names_bytes};
+                while (names_in.pos < names_in.len)
+                {
+                    ecs::Entity entity;
+                    str         name;
+                    if (!names_in.read(&entity, sizeof(ecs::Entity)) ||
+                        !read_value(names_in, name))
+                        return false;
+
+                    if (!alive_in(slots, entity)) return false;
+                    names.emplace_back(entity, std::move(name));
+                }
+
+                const BlockHeader* blocks = (const BlockHeader*)(data + table);
+                const BlockHeader* found[TYPES > 0 ? TYPES : 1]{};
+                std::tuple<std::vector<Types>...> decoded;
+                std::vector<bool>                 seen(header.slots, false);
+
+                u32  next  = 0;
+                bool valid = true;
+                (
+                    [&]()
+                    {
+                        const BlockHeader* block =
+                            find_block(blocks, header.blocks, type_id<Types>());
+                        if (valid && block)
+                            valid = check_block<Types>(
+                                data, len, slots, seen, *block,
+                                std::get<std::vector<Types>>(decoded)
+                            );
+                        found[next++] = block;
+                    }(),
+                    ...
+                );
+                if (!valid) return false;
+
+                world.reset();
+
+                auto& entities = world.entities;
+                entities.slots.assign(slots.begin(), slots.end());
+                entities.free_list           = header.free_list;
+                entities.num_active_entities = header.active;
+
+                for (auto& [entity, name] : names)
+                {
+                    entities.entity_to_name[entity] = name;
+                    entities.name_to_entity[name]   = entity;
+                }
+
+                next = 0;
+                (
+                    [&]()
+                    {
+                        const BlockHeader* block = found[next++];
+                        if (block)
+                            load_block<Types>(
+                                data, *block,
+                                std::get<std::vector<Types>>(decoded), world
+                            );
+                    }(),
+                    ...
+                );
+
+                return true;
+            }
+
+            /**
+             * @brief Writes a world's entities and the components of the given
+             * types to a file.
+             *
+             * @return Whether the file was written.
+             */
+            template<typename... Types>
+            inline bool write(ecs::World& world, const str& path)
+            {
+                std::vector<u8> bytes = serialize<Types...>(world);
+                return platform::filesystem::write_file(
+                    path, bytes.data(), bytes.size()
+                );
+            }
+
+            /**
+             * @brief Maps a file written by `write` into memory and loads it
+             * into a world. Raw component columns are inserted straight from
+             * the mapping.
+             *
+             * @return Whether the file was found and valid.
+             */
+            template<typename... Types>
+            inline bool read(ecs::World& world, const str& path)
+            {
+                platform::filesystem::MappedFile file(path);
+                if (!file.is_open()) return false;
+
+                return deserialize<Types...>(world, file.data(), file.len());
+            }
+        }
+    }
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/entities/entitymanager.h>
+#include <blocs/ecs/components/componentmanager.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        struct Commands;
+
+        /**
+         * @brief Records commands for a single entity, which may be an entity
+         * that will be spawned when the commands are applied.
+         */
+        struct EntityCommands
+        {
+            Commands* commands;
+            /** Entity, or index of the spawn command when pending. */
+            Entity    entity;
+            bool      pending;
+
+            template<typename T, typename... Args>
+            EntityCommands& add(Args&&... args);
+
+            template<typename T>
+            EntityCommands& remove();
+
+            void destroy();
+        };
+
+        /**
+         * @brief Buffer of structural changes (spawning and destroying
+         * entities, adding and removing components) recorded while iterating
+         * and applied later in one batch. Safe to record into from multiple
+         * threads.
+         */
+        struct Commands
+        {
+            enum class Type : uchar
+            {
+                SPAWN,
+                DESTROY,
+                ADD,
+                REMOVE,
+            };
+
+            struct Command
+            {
+                Type   type;
+                Entity entity;
+                bool   pending;
+
+                std::function<void(ComponentManager&, Entity)> apply;
+            };
+
+        private:
+            std::vector<Command> m_commands;
+            Entity               m_spawns = 0;
+            std::mutex           m_mutex;
+
+            void push(Command command)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_commands.push_back(std::move(command));
+            }
+
+        public:
+            /**
+             * @brief Records spawning a new entity.
+             *
+             * @return Commands for the entity, which is created when the
+             * buffer is applied.
+             */
+            EntityCommands spawn()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                Entity index = m_spawns++;
+                m_commands.push_back({Type::SPAWN, index, true, nullptr});
+                return {this, index, true};
+            }
+
+            /**
+             * @param entity Existing entity to record commands for.
+             *
+             * @return Commands for the entity.
+             */
+            EntityCommands entity(Entity entity)
+            {
+                return {this, entity, false};
+            }
+
+            /**
+             * @brief Records destroying an entity. Other commands for the same
+             * entity in the buffer are skipped.
+             *
+             * @param entity Entity to destroy.
+             */
+            void destroy(Entity entity) { this->entity(entity).destroy(); }
+
+            /**
+             * @brief Records adding a component to an entity.
+             *
+             * @tparam T type of component to add.
+             * @param entity Entity the component will be added to.
+             * @param args Arguments to pass to the constructor of component
+             * type T.
+             */
+            template<typename T, typename... Args>
+            void add(Entity entity, Args&&... args)
+            {
+                this->entity(entity).template add<T>(
+                    std::forward<Args>(args)...
+                );
+            }
+
+            /**
+             * @brief Records removing a component from an entity.
+             *
+             * @tparam T type of component to remove.
+             * @param entity Entity the component will be removed from.
+             */
+            template<typename T>
+            void remove(Entity entity)
+            {
+                this->entity(entity).template remove<T>();
+            }
+
+            template<typename T>
+            void record_add(const EntityCommands& target, T component)
+            {
+                push(
+                    {Type::ADD, target.entity, target.pending,
+                     [component](ComponentManager& components, Entity entity)
+                     { components.insert<T>(entity, component); }}
+                );
+            }
+
+            template<typename T>
+            void record_remove(const EntityCommands& target)
+            {
+                push(
+                    {Type::REMOVE, target.entity, target.pending,
+                     [](ComponentManager& components, Entity entity)
+                     { components.remove<T>(entity); }}
+                );
+            }
+
+            void record_destroy(const EntityCommands& target)
+            {
+                push({Type::DESTROY, target.entity, target.pending, nullptr});
+            }
+
+            /** @return Whether no commands have been recorded. */
+            bool empty()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_commands.empty();
+            }
+
+            /** @brief Discards every recorded command. */
+            void clear()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_commands.clear();
+                m_spawns = 0;
+            }
+
+            /**
+             * @brief Applies every recorded command in the order it was
+             * recorded and clears the buffer. Commands targeting an entity
+             * that is destroyed in the same batch or is no longer alive are
+             * skipped, as are repeated destroys.
+             *
+             * @param entities Entity manager to spawn and destroy entities in.
+             * @param components Component manager to change components in.
+             */
+            void apply(EntityManager& entities, ComponentManager& components)
+            {
+                std::vector<Command> commands;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    commands.swap(m_commands);
+                    m_spawns = 0;
+                }
+                if (commands.empty()) return;
+
+                // Entities destroyed by this batch don't need any of their
+                // other commands applied.
+                std::unordered_set<Entity> destroyed;
+                std::unordered_set<Entity> destroyed_spawns;
+                for (const auto& command : commands)
+                {
+                    if (command.type != Type::DESTROY) continue;
+
+                    if (command.pending)
+                        destroyed_spawns.insert(command.entity);
+                    else
+                        destroyed.insert(command.entity);
+                }
+
+                std::vector<Entity> spawned;
+                for (auto& command : commands)
+                {
+                    if (command.type == Type::SPAWN)
+                    {
+                        spawned.push_back(entities.create());
+                        continue;
+                    }
+
+                    Entity entity = command.pending ? spawned[command.entity]
+                                                    : command.entity;
+
+                    if (command.type == Type::DESTROY)
+                    {
+                        if (entities.alive(entity))
+                        {
+                            entities.remove(entity);
+                            components.destroy(entity);
+                        }
+                    }
+                    else if (command.pending
+                                 ? !destroyed_spawns.count(command.entity)
+                                 : !destroyed.count(entity) &&
+                                       entities.alive(entity))
+                    {
+                        command.apply(components, entity);
+                    }
+                }
+            }
+        };
+
+        template<typename T, typename... Args>
+        EntityCommands& EntityCommands::add(Args&&... args)
+        {
+            commands->record_add<T>(*this, T(args...));
+            return *this;
+        }
+
+        template<typename T>
+        EntityCommands& EntityCommands::remove()
+        {
+            commands->record_remove<T>(*this);
+            return *this;
+        }
+
+        inline void EntityCommands::destroy()
+        {
+            commands->record_destroy(*this);
+        }
+    }
+}
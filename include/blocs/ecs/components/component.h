@@ -1,9 +1,195 @@
 #pragma once
 
+#include <atomic>
+#include <bit>
+#include <mutex>
+
 namespace blocs
 {
     namespace ecs
     {
         using Component = u8;
+
+        /**
+         * @return Next unused component type id. Ids are shared by every
+         * world.
+         */
+        inline Component next_component_type()
+        {
+            static std::atomic<u32> s_next{0};
+
+            u32 next = s_next++;
+            assert(
+                next < ecs::MAX_COMPONENTS &&
+                "ERROR: exceeded the maximum number of component types"
+            );
+            return (Component)next;
+        }
+
+        /**
+         * @brief Id of a component type plus one, or 0 until assigned.
+         * Constant initialized, so it is zero before any static initializer
+         * runs and reading it needs no guard.
+         */
+        template<typename T>
+        inline constinit std::atomic<u32> component_type_slot{0};
+
+        /**
+         * @brief Assigns an id to a component type that has none yet. Ids
+         * are assigned under a lock so racing threads don't use up ids.
+         *
+         * @param slot Id slot of the component type.
+         *
+         * @return Id of the component type plus one.
+         */
+        inline u32 assign_component_type(std::atomic<u32>& slot)
+        {
+            static constinit std::mutex s_mutex;
+
+            std::lock_guard<std::mutex> lock(s_mutex);
+            u32 id = slot.load(std::memory_order_relaxed);
+            if (id == 0)
+            {
+                id = next_component_type() + 1;
+                slot.store(id, std::memory_order_relaxed);
+            }
+            return id;
+        }
+
+        /**
+         * @return Id of a component type, assigned the first time it is
+         * asked for and the same in every world. Safe to call from static
+         * initializers; afterwards each call is a single relaxed load.
+         */
+        template<typename T>
+        inline Component component_type()
+        {
+            u32 id = component_type_slot<T>.load(std::memory_order_relaxed);
+            if (id == 0) [[unlikely]]
+                id = assign_component_type(component_type_slot<T>);
+            return (Component)(id - 1);
+        }
+
+        /**
+         * @brief Counter advanced by the world as stages and systems run.
+         * Components record the tick they were added and last changed at.
+         */
+        using Tick = u32;
+
+        /**
+         * Ticks older than this are clamped to it, keeping every recorded tick
+         * within half the tick range of the current one.
+         */
+        constexpr Tick MAX_TICK_AGE = Tick(1) << 30;
+
+        /** Number of ticks between clamping old ticks. */
+        constexpr Tick TICK_CHECK_INTERVAL = MAX_TICK_AGE / 2;
+
+        /**
+         * @return Whether a tick is newer than another, correct across the
+         * tick counter wrapping around.
+         */
+        constexpr bool tick_newer(Tick tick, Tick than)
+        {
+            return (i32)(tick - than) > 0;
+        }
+
+        /** @return A tick, or `oldest` if the tick is older. */
+        constexpr Tick clamp_tick(Tick tick, Tick oldest)
+        {
+            return tick_newer(oldest, tick) ? oldest : tick;
+        }
+
+        /**
+         * @brief Bitmask with one bit for every registered component type.
+         * Describes which components an entity (or signature bucket) owns.
+         */
+        struct Signature
+        {
+            static constexpr size WORDS = (ecs::MAX_COMPONENTS + 63) / 64;
+
+            u64 words[WORDS]{};
+
+            void set(Component type) { words[type / 64] |= 1ULL << type % 64; }
+            void reset(Component type)
+            {
+                words[type / 64] &= ~(1ULL << type % 64);
+            }
+
+            bool test(Component type) const
+            {
+                return words[type / 64] & (1ULL << type % 64);
+            }
+
+            /** @return Whether every bit set in `other` is also set. */
+            bool contains(const Signature& other) const
+            {
+                for (size i = 0; i < WORDS; i++)
+                {
+                    if ((words[i] & other.words[i]) != other.words[i])
+                        return false;
+                }
+                return true;
+            }
+
+            /** @return Whether any bit is set in both signatures. */
+            bool intersects(const Signature& other) const
+            {
+                for (size i = 0; i < WORDS; i++)
+                {
+                    if ((words[i] & other.words[i]) != 0) return true;
+                }
+                return false;
+            }
+
+            /**
+             * @brief Calls a function with every component type in the
+             * signature, scanning a word at a time.
+             *
+             * @param func Called with each set `Component` type.
+             */
+            template<typename Func>
+            void each(Func func) const
+            {
+                for (size i = 0; i < WORDS; i++)
+                {
+                    for (u64 word = words[i]; word != 0; word &= word - 1)
+                        func((Component)(i * 64 + std::countr_zero(word)));
+                }
+            }
+
+            bool empty() const
+            {
+                for (size i = 0; i < WORDS; i++)
+                {
+                    if (words[i] != 0) return false;
+                }
+                return true;
+            }
+
+            bool operator==(const Signature& other) const
+            {
+                for (size i = 0; i < WORDS; i++)
+                {
+                    if (words[i] != other.words[i]) return false;
+                }
+                return true;
+            }
+
+            struct Hash
+            {
+                size operator()(const Signature& signature) const
+                {
+                    size hash = 0;
+                    for (size i = 0; i < WORDS; i++)
+                    {
+                        hash ^= std::hash<u64>{}(signature.words[i]) +
+                                0x9e3779b97f4a7c15ULL + (hash << 6) +
+                                (hash >> 2);
+                    }
+                    return hash;
+                }
+            };
+        };
     }
 }
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
 #include <unordered_map>
+#include <span>
+#include <vector>
 
 #include <blocs/common.h>
 #include <blocs/ecs/sparse.h>
@@ -10,69 +15,364 @@ namespace blocs
 {
     namespace ecs
     {
+        /** @brief Memory used by the storage of a single component type. */
+        struct ComponentMemoryUsage
+        {
+            /** Implementation defined name of the component type. */
+            cstr name;
+            /** Number of components currently stored. */
+            size count;
+            /** Bytes allocated for component data and the sparse set. */
+            size bytes;
+        };
+
+        /**
+         * @brief Copy of a component array's entities, ticks and components,
+         * taken for a snapshot.
+         */
+        struct ComponentBlock
+        {
+            Component type;
+            /** Number of components. */
+            size      len = 0;
+            /**
+             * Entities, added ticks, changed ticks and (for trivially copyable
+             * types) components, packed back to back.
+             */
+            std::vector<u8>       bytes;
+            /** Copy of the components of non trivially copyable types. */
+            std::shared_ptr<void> objects;
+            /** Whether `bytes` is a delta against a base snapshot's block. */
+            bool                  delta = false;
+        };
+
         /** @brief Interface for component array virtual inheritance. */
         struct IComponentArray
         {
             virtual ~IComponentArray() = default;
 
-            virtual void remove(Entity entity) = 0;
-            virtual void reset()               = 0;
+            virtual void remove(Entity entity)      = 0;
+            virtual void reset()                    = 0;
+            virtual void swap(size a, size b)       = 0;
+            virtual size index(Entity entity) const = 0;
+
+            virtual void save(ComponentBlock& block) const = 0;
+            virtual void load(const ComponentBlock& block, Tick tick) = 0;
+
+            virtual void clamp_ticks(Tick oldest) = 0;
+
+            virtual ComponentMemoryUsage memory_usage() const = 0;
         };
 
         /**
          * @brief Container for component data and maintains
          * relationship between components and entities.
          *
-         * @tparam T Type of component.
+         * @tparam T Type of component. Empty types are tags: only the
+         * entities owning them are stored.
          */
         template<typename T>
         struct ComponentArray : public IComponentArray
         {
+            /** Whether T has no data, so no components need storing. */
+            static constexpr bool TAG = std::is_empty_v<T>;
+
             /**
-             * @brief Packed array of components contiguous in memory
-             * with one index for each entity.
+             * @brief Packed array of components contiguous in memory stored in
+             * the same order as the entities in `set.dense`. Grows on demand,
+             * so references are invalidated when components are added. Always
+             * empty for tags.
              */
-            T                  components[ecs::MAX_ENTITIES];
+            std::vector<T>     components;
             sparse_set<Entity> set{ecs::MAX_ENTITIES};
 
             /**
-             * @brief Adds a component to the next available index in the packed
-             * array. Then creates two maps between entity and array index.
+             * @brief Tick each component was added at, in the same order as
+             * `components`.
+             */
+            std::vector<Tick> added_ticks;
+            /**
+             * @brief Tick each component was last changed at, in the same
+             * order as `components`.
+             */
+            std::vector<Tick> changed_ticks;
+
+            /**
+             * @brief Adds a component to the end of the packed array (or
+             * overwrites the existing component if the entity already has one)
+             * and maps the entity to its array index.
              *
              * @param entity 	Entity the component belongs to.
              * @param component Component being added to packed array.
+             * @param tick      Current tick, recorded as the change tick (and
+             * the added tick of new components).
              *
              * @return Reference to the added component.
              */
-            T& insert(Entity entity, T component)
+            T& insert(Entity entity, T component, Tick tick = 0)
             {
+                if (set.has(entity))
+                {
+                    auto index           = set.index(entity);
+                    changed_ticks[index] = tick;
+                    return at(index) = component;
+                }
+
+                if constexpr (!TAG) components.push_back(component);
+                added_ticks.push_back(tick);
+                changed_ticks.push_back(tick);
                 set.add(entity);
-                components[set.value(entity)] = component;
-                return components[set.value(entity)];
+                return at(set.index(entity));
+            }
+
+            /**
+             * @brief Inserts a component for each of a list of entities,
+             * growing storage once. When none of the entities already own a
+             * component and none repeat, the components are appended in one
+             * copy (a `memcpy` for trivially copyable types). Otherwise they
+             * are inserted one at a time in order, so the last component given
+             * for a repeated entity wins.
+             *
+             * @param entities Entities the components belong to.
+             * @param values Components, one per entity.
+             * @param tick Current tick.
+             */
+            void insert_batch(
+                std::span<const Entity> entities, std::span<const T> values,
+                Tick tick = 0
+            )
+            {
+                assert(
+                    (TAG || entities.size() == values.size()) &&
+                    "ERROR: batch needs one component per entity"
+                );
+
+                auto count = set.len + entities.size();
+                set.reserve(count);
+                for (blocs::size i = 0; i < entities.size(); i++)
+                {
+                    if (!set.has(entities[i]))
+                    {
+                        set.add(entities[i]);
+                        continue;
+                    }
+
+                    // Owned already or repeated in the batch, undo the
+                    // entities added so far
+                    while (i-- > 0) set.remove(entities[i]);
+
+                    for (blocs::size j = 0; j < entities.size(); j++)
+                        insert(entities[j], TAG ? T{} : values[j], tick);
+                    return;
+                }
+
+                if constexpr (!TAG)
+                    components.insert(
+                        components.end(), values.begin(), values.end()
+                    );
+                added_ticks.resize(count, tick);
+                changed_ticks.resize(count, tick);
             }
 
             /**
-             * @brief Removes an entity and updates the maps to keep array data
-             * packed.
+             * @brief Removes an entity by moving the last component into its
+             * slot (swap-and-pop) to keep array data packed.
              *
              * @param entity Entity to remove.
              */
-            void remove(Entity entity) override { set.remove(entity); }
+            void remove(Entity entity) override
+            {
+                if (!set.has(entity)) return;
+
+                auto index = set.index(entity);
+                auto last  = set.len - 1;
+                if (index != last)
+                {
+                    if constexpr (!TAG)
+                        components[index] = std::move(components[last]);
+                    added_ticks[index]   = added_ticks[last];
+                    changed_ticks[index] = changed_ticks[last];
+                }
+
+                if constexpr (!TAG) components.pop_back();
+                added_ticks.pop_back();
+                changed_ticks.pop_back();
+                set.remove(entity);
+            }
+
+            /**
+             * @brief Swaps two components (and their entities) in the packed
+             * array.
+             *
+             * @param a Packed index of the first component.
+             * @param b Packed index of the second component.
+             */
+            void swap(blocs::size a, blocs::size b) override
+            {
+                if (a == b) return;
+
+                if constexpr (!TAG) std::swap(components[a], components[b]);
+                std::swap(added_ticks[a], added_ticks[b]);
+                std::swap(changed_ticks[a], changed_ticks[b]);
+                set.swap(a, b);
+            }
+
+            /**
+             * @brief Copies the populated part of the array into a block.
+             * Trivially copyable components are copied as bytes.
+             */
+            void save(ComponentBlock& block) const override
+            {
+                constexpr bool RAW = !TAG && std::is_trivially_copyable_v<T>;
+
+                auto len   = set.len;
+                block.len  = len;
+                block.bytes.resize(
+                    len * (sizeof(Entity) + 2 * sizeof(Tick) +
+                           (RAW ? sizeof(T) : 0))
+                );
 
-            /** @brief Resets all component member values to default. */
+                u8*  out   = block.bytes.data();
+                auto write = [&](const auto* data)
+                {
+                    std::memcpy(out, data, len * sizeof(*data));
+                    out += len * sizeof(*data);
+                };
+
+                write(set.dense.data());
+                write(added_ticks.data());
+                write(changed_ticks.data());
+                if constexpr (RAW)
+                    write(components.data());
+                else if constexpr (!TAG)
+                    block.objects =
+                        std::make_shared<std::vector<T>>(components);
+            }
+
+            /**
+             * @brief Replaces the array's contents with a block saved from an
+             * array of the same type. Every loaded component is marked as
+             * changed at `tick`, and no added tick is left newer than it.
+             */
+            void load(const ComponentBlock& block, Tick tick) override
+            {
+                constexpr bool RAW = !TAG && std::is_trivially_copyable_v<T>;
+
+                auto      len  = block.len;
+                const u8* in   = block.bytes.data();
+                auto      read = [&](auto* data)
+                {
+                    std::memcpy(data, in, len * sizeof(*data));
+                    in += len * sizeof(*data);
+                };
+
+                set.assign((const Entity*)in, len);
+                in += len * sizeof(Entity);
+
+                added_ticks.resize(len);
+                changed_ticks.resize(len);
+                read(added_ticks.data());
+                in += len * sizeof(Tick);
+
+                // Restored values differ from whatever the readers saw last
+                std::fill(changed_ticks.begin(), changed_ticks.end(), tick);
+                for (Tick& added : added_ticks)
+                {
+                    if (tick_newer(added, tick)) added = tick;
+                }
+
+                if constexpr (RAW)
+                {
+                    components.resize(len);
+                    read(components.data());
+                }
+                else if constexpr (!TAG)
+                    components = *(const std::vector<T>*)block.objects.get();
+            }
+
+            /** @brief Clamps added and changed ticks older than `oldest`. */
+            void clamp_ticks(Tick oldest) override
+            {
+                for (blocs::size i = 0; i < set.len; i++)
+                {
+                    added_ticks[i]   = clamp_tick(added_ticks[i], oldest);
+                    changed_ticks[i] = clamp_tick(changed_ticks[i], oldest);
+                }
+            }
+
+            /** @brief Removes all components. */
             void reset() override
             {
-                memset(components, 0, sizeof(components));
+                components.clear();
+                added_ticks.clear();
+                changed_ticks.clear();
                 set.clear();
             }
 
+            ComponentMemoryUsage memory_usage() const override
+            {
+                return {
+                    typeid(T).name(), set.len,
+                    components.capacity() * sizeof(T) +
+                        (added_ticks.capacity() + changed_ticks.capacity()) *
+                            sizeof(Tick) +
+                        set.memory_usage()};
+            }
+
             /**
              * @param entity Entity to get the component of.
              *
              * @return Reference to the component belonging to the specified
              * entity.
              */
-            T& get(Entity entity) { return components[set.value(entity)]; }
+            T& get(Entity entity) { return at(set.index(entity)); }
+
+            /**
+             * @param entity Entity owning a component of type T.
+             *
+             * @return Position of the entity's component in the packed array.
+             */
+            blocs::size index(Entity entity) const override
+            {
+                return set.index(entity);
+            }
+
+            /**
+             * @param index Position in the packed array.
+             *
+             * @return Reference to the component stored at the packed index,
+             * or to a single shared instance for tags.
+             */
+            T& at(blocs::size index)
+            {
+                if constexpr (TAG)
+                {
+                    static T s_tag;
+                    return s_tag;
+                }
+                else
+                    return components[index];
+            }
+
+            /**
+             * @param entity Entity to get the component of.
+             *
+             * @return Tick the entity's component was added at.
+             */
+            Tick added_tick(Entity entity) const
+            {
+                return added_ticks[set.index(entity)];
+            }
+
+            /**
+             * @param entity Entity to get the component of.
+             *
+             * @return Tick the entity's component was last changed at.
+             */
+            Tick changed_tick(Entity entity) const
+            {
+                return changed_ticks[set.index(entity)];
+            }
 
             /**
              * @param entity Which entity to check for the component.
@@ -81,9 +381,9 @@ namespace blocs
              */
             bool has(Entity entity) const { return set.has(entity); }
 
-            size size() const { return set.len; }
+            blocs::size size() const { return set.len; }
 
-            T& get_singleton() { return components[set.dense[0]]; }
+            T& get_singleton() { return at(0); }
         };
     }
 }
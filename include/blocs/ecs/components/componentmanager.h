@@ -1,10 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+
 #include <blocs/common.h>
 #include <blocs/ecs/entities/entity.h>
 #include <blocs/ecs/entities/entitymanager.h>
 #include <blocs/ecs/components/component.h>
 #include <blocs/ecs/components/componentarray.h>
+#include <blocs/ecs/signatures/signatureindex.h>
+#include <blocs/ecs/queries/querycache.h>
+#include <blocs/ecs/queries/componentgroup.h>
 
 namespace blocs
 {
@@ -17,34 +25,131 @@ namespace blocs
         class ComponentManager
         {
         private:
-            IComponentArray* m_componentArrays[ecs::MAX_COMPONENTS]{nullptr};
-            u8               m_nextComponentType = 0;
+            /**
+             * Component arrays by component type, registered on first use.
+             * Systems running in parallel may query types nobody added yet,
+             * so registration is guarded by `m_registerMutex`.
+             */
+            std::atomic<IComponentArray*> m_componentArrays[MAX_COMPONENTS]{};
+            std::mutex                    m_registerMutex;
 
-            template<typename T>
-            inline u8 get_type_id()
+            /** Component types owned by an entity. */
+            struct EntitySignature
+            {
+                Entity    entity;
+                Signature signature;
+            };
+
+            /** Signature of every entity, indexed by entity index. */
+            std::vector<EntitySignature> m_signatures;
+
+            /** Entities by signature, only maintained when enabled. */
+            std::unique_ptr<SignatureIndex> m_signatureIndex = nullptr;
+
+            /** Registered persistent queries. */
+            std::vector<std::unique_ptr<QueryCache>> m_caches;
+
+            /** Registered owning groups. */
+            std::vector<std::unique_ptr<ComponentGroup>> m_groups;
+
+            /** Tick recorded when components are added or changed. */
+            std::atomic<Tick> m_tick{1};
+            /** Changes newer than this tick pass `Changed`/`Added` filters. */
+            Tick              m_lastTick = 0;
+
+            /** Ticks of the system running on a thread. */
+            struct SystemTicks
+            {
+                const ComponentManager* owner = nullptr;
+                Tick                    tick  = 0;
+                Tick                    last  = 0;
+            };
+
+            static SystemTicks& local_ticks()
+            {
+                static thread_local SystemTicks s_ticks;
+                return s_ticks;
+            }
+
+            /**
+             * @brief Updates the signature index, persistent queries and
+             * groups after an entity's signature changed. Called after a
+             * component is inserted and before one is removed.
+             */
+            void on_signature_changed(
+                Entity entity, const Signature& prev, const Signature& next
+            )
             {
-                static u8 s_component = ++m_nextComponentType;
-                return s_component;
+                if (m_signatureIndex) m_signatureIndex->update(entity, next);
+                for (auto& cache : m_caches) cache->update(entity, prev, next);
+                for (auto& group : m_groups) group->update(entity, prev, next);
+            }
+
+            /**
+             * @return Signature record for an entity, reset if it belonged to
+             * a previous version of the entity.
+             */
+            EntitySignature& assure_signature(Entity entity)
+            {
+                EntityIndex index = get_index(entity);
+                if (index >= m_signatures.size())
+                    m_signatures.resize(index + 1, {NULL_INDEX, {}});
+
+                EntitySignature& record = m_signatures[index];
+                if (record.entity != entity) record = {entity, {}};
+                return record;
+            }
+
+            /**
+             * @return Whether the signature record of the entity's index
+             * belongs to a newer version of the entity, making the handle
+             * stale.
+             */
+            bool stale(Entity entity) const
+            {
+                EntityIndex index = get_index(entity);
+                if (index >= m_signatures.size()) return false;
+
+                Entity owner = m_signatures[index].entity;
+                return get_index(owner) == index &&
+                       (i32)(get_version(owner) - get_version(entity)) > 0;
             }
 
             /*
-             * Creates new ComponentArray of type T
-             * and inserts into map using typename as key.
+             * Creates new ComponentArray of type T, unless another thread
+             * registered it first.
              *
              * @tparam T the type of component to register.
+             *
+             * @return Component array of type T.
              */
             template<typename T>
-            void register_component()
+            IComponentArray* register_component()
             {
                 u8 type = get_type_id<T>();
-                assert(
-                    m_componentArrays[type] == nullptr &&
-                    "ERROR: already registered component"
-                );
-                m_componentArrays[type] = new ComponentArray<T>();
+
+                std::lock_guard<std::mutex> lock(m_registerMutex);
+                IComponentArray* components = m_componentArrays[type].load();
+                if (components == nullptr)
+                {
+                    components = new ComponentArray<T>();
+                    m_componentArrays[type].store(components);
+                }
+                return components;
             }
 
         public:
+            /**
+             * @tparam T type of component, `const` qualified or not.
+             *
+             * @return Id of the component type, used as its signature bit.
+             */
+            template<typename T>
+            static inline u8 get_type_id()
+            {
+                return component_type<std::remove_const_t<T>>();
+            }
+
             /**
              * @brief Creates a new component of type T (with passed in
              * arguments or default constructor) and associates with an entity.
@@ -59,21 +164,93 @@ namespace blocs
             template<typename T, typename... Args>
             T& add(Entity entity, Args&&... args)
             {
-                return get_components<T>()->insert(entity, T(args...));
+                return insert<T>(entity, T(args...));
             }
 
             /**
              * @brief Inserts a premade component of type T into a component
-             * array and associates with an entity.
+             * array and associates with an entity. Components inserted through
+             * a stale handle of a destroyed entity are discarded.
              *
              * @tparam T type of component being added.
              * @param entity Entity the component will be added to.
              * @param component Component being inserted.
+             *
+             * @return Reference to the new component, or to the discarded
+             * component if the handle is stale.
              */
             template<typename T>
             T& insert(Entity entity, T component)
             {
-                return get_components<T>()->insert(entity, component);
+                if (stale(entity))
+                {
+                    static thread_local std::optional<T> s_discarded;
+                    return s_discarded.emplace(std::move(component));
+                }
+
+                auto* component_array = get_components<T>();
+                component_array->insert(entity, component, tick());
+
+                auto& record = assure_signature(entity);
+                if (!record.signature.test(get_type_id<T>()))
+                {
+                    Signature prev = record.signature;
+                    record.signature.set(get_type_id<T>());
+                    on_signature_changed(entity, prev, record.signature);
+                }
+
+                // Joining a group may have moved the component
+                return component_array->get(entity);
+            }
+
+            /**
+             * @brief Inserts premade components of type T for many entities
+             * at once. Component storage grows once and the components are
+             * copied in bulk. Entities with stale handles are skipped.
+             *
+             * @tparam T type of component being added.
+             * @param entities Entities the components will be added to.
+             * @param components Components being inserted, one per entity.
+             */
+            template<typename T>
+            void insert_batch(
+                std::span<const Entity> entities, std::span<const T> components
+            )
+            {
+                auto is_stale = [&](Entity entity) { return stale(entity); };
+                if (std::any_of(entities.begin(), entities.end(), is_stale))
+                {
+                    std::vector<Entity> live_entities;
+                    std::vector<T>      live_components;
+                    for (size i = 0; i < entities.size(); i++)
+                    {
+                        if (stale(entities[i])) continue;
+                        live_entities.push_back(entities[i]);
+                        live_components.push_back(components[i]);
+                    }
+                    insert_batch<T>(live_entities, live_components);
+                    return;
+                }
+
+                get_components<T>()->insert_batch(
+                    entities, components, tick()
+                );
+
+                EntityIndex last = 0;
+                for (auto entity : entities)
+                    last = std::max(last, get_index(entity));
+                if (last >= m_signatures.size())
+                    m_signatures.resize(last + 1, {NULL_INDEX, {}});
+
+                for (auto entity : entities)
+                {
+                    auto& record = assure_signature(entity);
+                    if (record.signature.test(get_type_id<T>())) continue;
+
+                    Signature prev = record.signature;
+                    record.signature.set(get_type_id<T>());
+                    on_signature_changed(entity, prev, record.signature);
+                }
             }
 
             /**
@@ -85,49 +262,176 @@ namespace blocs
             template<typename T>
             void remove(Entity entity)
             {
+                if (!has<T>(entity)) return;
+
+                auto&     record = m_signatures[get_index(entity)];
+                Signature prev   = record.signature;
+                record.signature.reset(get_type_id<T>());
+                on_signature_changed(entity, prev, record.signature);
+
                 get_components<T>()->remove(entity);
             }
 
             /**
-             * @brief Removes all components belonging to an entity.
+             * @brief Removes all components belonging to an entity. Only the
+             * component arrays in the entity's signature are touched.
              *
              * @param entity Entity to remove all components from.
              */
             void remove(Entity entity)
             {
-                for (i32 i = 0; i < ecs::MAX_COMPONENTS; i++)
-                {
-                    if (m_componentArrays[i] != nullptr)
-                    {
-                        m_componentArrays[i]->remove(entity);
-                    }
-                }
+                EntityIndex index = get_index(entity);
+                if (index >= m_signatures.size() ||
+                    m_signatures[index].entity != entity)
+                    return;
+
+                auto&     record = m_signatures[index];
+                Signature prev   = record.signature;
+                record.signature = {};
+                on_signature_changed(entity, prev, record.signature);
+
+                prev.each(
+                    [&](Component type)
+                    { get_components(type)->remove(entity); }
+                );
             }
 
             /**
-             * @brief Returns ComponentArray for type T.
+             * @brief Removes all components of a destroyed entity and retires
+             * its signature record to the entity's next version, so later
+             * inserts through the destroyed handle are rejected.
+             *
+             * @param entity Entity being destroyed.
+             */
+            void destroy(Entity entity)
+            {
+                if (stale(entity)) return;
+
+                remove(entity);
+                assure_signature(entity).entity =
+                    make_entity(get_index(entity), get_version(entity) + 1);
+            }
+
+            /**
+             * @param entity Entity to get the signature of.
+             *
+             * @return Component types owned by the entity.
+             */
+            const Signature& get_signature(Entity entity) const
+            {
+                static const Signature s_empty{};
+
+                EntityIndex index = get_index(entity);
+                if (index >= m_signatures.size() ||
+                    m_signatures[index].entity != entity)
+                    return s_empty;
+                return m_signatures[index].signature;
+            }
+
+            /**
+             * @brief Returns ComponentArray for type T, registering it on
+             * first use. Safe to call from systems running in parallel.
              *
              * @tparam T the type of requested ComponentArray.
              */
             template<typename T>
-            ComponentArray<T>* get_components()
+            ComponentArray<std::remove_const_t<T>>* get_components()
             {
-                u8 type = get_type_id<T>();
-                if (m_componentArrays[type] != nullptr)
-                    return (ComponentArray<T>*)m_componentArrays[type];
-                else
+                using Type = std::remove_const_t<T>;
+
+                u8               type       = get_type_id<Type>();
+                IComponentArray* components = m_componentArrays[type].load(
+                    std::memory_order_acquire
+                );
+                if (components == nullptr)
+                    components = register_component<Type>();
+                return (ComponentArray<Type>*)components;
+            }
+
+            /**
+             * @tparam Types types of components to compare.
+             *
+             * @return Entity set of the component type with the fewest
+             * components (the first type wins ties).
+             */
+            template<typename... Types>
+            sparse_set<Entity>* get_smallest_set()
+            {
+                sparse_set<Entity>* sets[] = {&get_components<Types>()->set...};
+
+                sparse_set<Entity>* smallest = sets[0];
+                for (auto* set : sets)
                 {
-                    register_component<T>();
-                    return get_components<T>();
+                    if (set->len < smallest->len) smallest = set;
                 }
+                return smallest;
+            }
+
+            /**
+             * @tparam Types types of components to align.
+             *
+             * @return Whether `align` may reorder the arrays of the component
+             * types: none of them is owned by a group, or a group owns
+             * exactly these types.
+             */
+            template<typename... Types>
+            bool can_align()
+            {
+                Signature types = signature<Types...>();
+                for (auto& group : m_groups)
+                {
+                    if (group->owned != types && group->owned.intersects(types))
+                        return false;
+                }
+                return true;
+            }
+
+            /**
+             * @brief Moves the entities owning every component type to the
+             * front of each type's array, in the same order, so the arrays can
+             * be walked side by side. Every call walks the smallest of the
+             * arrays, but only swaps components that are out of place. Arrays
+             * owned by a group that does not own exactly these types are never
+             * reordered (see `can_align`).
+             *
+             * @tparam Types types of components to align.
+             *
+             * @return Number of entities owning every type, or 0 if the
+             * arrays cannot be aligned.
+             */
+            template<typename... Types>
+            size align()
+            {
+                Signature types = signature<Types...>();
+                if (auto* group = get_group(types)) return group->len;
+                if (!can_align<Types...>()) return 0;
+
+                auto* set = get_smallest_set<Types...>();
+
+                size count = 0;
+                for (size i = 0; i < set->len; i++)
+                {
+                    Entity entity = set->dense[i];
+                    if (!has<Types...>(entity)) continue;
+
+                    (get_components<Types>()->swap(
+                         get_components<Types>()->set.index(entity), count
+                     ),
+                     ...);
+                    count++;
+                }
+                return count;
             }
 
             IComponentArray* get_components(u8 type)
             {
-                return m_componentArrays[type];
+                return m_componentArrays[type].load(std::memory_order_acquire);
             }
 
             /**
+             * @brief Gets a component of an entity. Unless T is `const`, the
+             * component is marked as changed at the current tick.
+             *
              * @tparam T type of component to retrieve.
              * @param entity Entity to get component of type T from.
              *
@@ -136,32 +440,362 @@ namespace blocs
             template<typename T>
             T& get(Entity entity)
             {
-                return get_components<T>()->get(entity);
+                auto* component_array = get_components<T>();
+                auto  index           = component_array->set.index(entity);
+                if constexpr (!std::is_const_v<T>)
+                    component_array->changed_ticks[index] = tick();
+
+                return component_array->at(index);
             }
 
             /**
-             * @tparam T type of component to check for.
-             * @param Entity to check for component of type T.
+             * @brief Records changes at, and filters changes against, the
+             * ticks of a system on the current thread until destroyed.
+             */
+            class SystemScope
+            {
+            private:
+                SystemTicks m_prev;
+
+            public:
+                /**
+                 * @param tick Tick the system's changes are recorded at.
+                 * @param last Tick the system last ran at.
+                 */
+                SystemScope(
+                    const ComponentManager& components, Tick tick, Tick last
+                )
+                    : m_prev(local_ticks())
+                {
+                    local_ticks() = {&components, tick, last};
+                }
+
+                ~SystemScope() { local_ticks() = m_prev; }
+
+                SystemScope(const SystemScope&)            = delete;
+                SystemScope& operator=(const SystemScope&) = delete;
+            };
+
+            /**
+             * @return Tick recorded by components added or changed now, or
+             * the running system's tick on a thread inside a `SystemScope`.
+             */
+            Tick tick() const
+            {
+                const SystemTicks& local = local_ticks();
+                return local.owner == this ? local.tick : m_tick.load();
+            }
+
+            /**
+             * @return Tick that `Changed` and `Added` filters compare against,
+             * matching components changed after it. Inside a `SystemScope`
+             * this is the tick the running system last ran at.
+             */
+            Tick last_tick() const
+            {
+                const SystemTicks& local = local_ticks();
+                return local.owner == this ? local.last : m_lastTick;
+            }
+
+            /**
+             * @brief Sets the tick that `Changed` and `Added` filters compare
+             * against outside of systems, usually the tick the running stage
+             * last ran at.
+             */
+            void set_last_tick(Tick tick) { m_lastTick = tick; }
+
+            /**
+             * @brief Advances the current tick so later changes are newer than
+             * everything changed until now. Safe to call from any thread.
+             *
+             * @return The new tick.
+             */
+            Tick advance_tick() { return ++m_tick; }
+
+            /**
+             * @brief Clamps the added and changed ticks of every component
+             * older than `MAX_TICK_AGE`, so they still compare as old once
+             * the tick counter wraps around. Must not be called while systems
+             * are running.
+             *
+             * @return Oldest tick left, for clamping ticks stored elsewhere.
+             */
+            Tick clamp_ticks()
+            {
+                Tick oldest = m_tick - MAX_TICK_AGE;
+                for (auto& slot : m_componentArrays)
+                {
+                    IComponentArray* component_array = slot.load();
+                    if (component_array) component_array->clamp_ticks(oldest);
+                }
+                m_lastTick = clamp_tick(m_lastTick, oldest);
+                return oldest;
+            }
+
+            /**
+             * @tparam Types types of components to check for.
+             * @param Entity to check for components of type Types.
              *
-             * @return Whether an entity has a component of type T.
+             * @return Whether an entity has a component of every type, tested
+             * with a single signature mask.
              */
             template<typename... Types>
             bool has(Entity entity)
             {
-                return ((get_components<Types>()->set.has(entity)) && ...);
+                if constexpr (sizeof...(Types) == 0) return true;
+
+                EntityIndex index = get_index(entity);
+                return index < m_signatures.size() &&
+                       m_signatures[index].entity == entity &&
+                       m_signatures[index].signature.contains(
+                           signature<Types...>()
+                       );
+            }
+
+            /**
+             * @tparam Types types of components to include.
+             *
+             * @return Signature with a bit set for each component type.
+             */
+            template<typename... Types>
+            Signature signature()
+            {
+                Signature signature;
+                (signature.set(get_type_id<Types>()), ...);
+                return signature;
+            }
+
+            /**
+             * @brief Starts indexing entities by their component signature.
+             * Entities that already own components are added to their
+             * buckets.
+             */
+            void enable_signature_index()
+            {
+                if (m_signatureIndex) return;
+
+                m_signatureIndex = std::make_unique<SignatureIndex>();
+                for (const auto& record : m_signatures)
+                {
+                    if (!record.signature.empty())
+                        m_signatureIndex->update(
+                            record.entity, record.signature
+                        );
+                }
+            }
+
+            /**
+             * @brief Registers a persistent query over entities matching a
+             * mask, or returns the existing one for the same mask. Its members
+             * are kept up to date as components are added and removed.
+             *
+             * @param mask Component types members must and must not own.
+             *
+             * @return Cache of the matching entities.
+             */
+            QueryCache* register_cache(const QueryMask& mask)
+            {
+                for (auto& cache : m_caches)
+                {
+                    if (cache->mask == mask) return cache.get();
+                }
+
+                auto cache = std::make_unique<QueryCache>(mask);
+                for (const auto& record : m_signatures)
+                {
+                    if (cache->matches(record.signature))
+                        cache->members.add(record.entity);
+                }
+
+                m_caches.push_back(std::move(cache));
+                return m_caches.back().get();
+            }
+
+            /**
+             * @brief Registers an owning group for a set of component types,
+             * or returns the existing one for the same types. A component type
+             * can only be owned by one group.
+             *
+             * @tparam Types types of components owned by the group.
+             *
+             * @return The group.
+             */
+            template<typename... Types>
+            ComponentGroup* register_group()
+            {
+                Signature owned = signature<Types...>();
+                if (auto* group = get_group(owned)) return group;
+                assert(
+                    can_align<Types...>() &&
+                    "ERROR: component type is already owned by a group"
+                );
+
+                auto group    = std::make_unique<ComponentGroup>();
+                group->owned  = owned;
+                group->arrays = {get_components<Types>()...};
+                group->len    = align<Types...>();
+
+                m_groups.push_back(std::move(group));
+                return m_groups.back().get();
             }
 
             /**
-             * @brief Calls `reset` on all Component Arrays which reinitializes
-             * all components to their default values.
+             * @param owned Component types owned by the group.
+             *
+             * @return Group owning exactly the component types, or `nullptr`.
+             */
+            ComponentGroup* get_group(const Signature& owned)
+            {
+                for (auto& group : m_groups)
+                {
+                    if (group->owned == owned) return group.get();
+                }
+                return nullptr;
+            }
+
+            /**
+             * @return Entities by signature, or `nullptr` if the signature
+             * index is not enabled.
+             */
+            SignatureIndex* get_signature_index()
+            {
+                return m_signatureIndex.get();
+            }
+
+            /**
+             * @return Memory used by each registered component type.
+             */
+            std::vector<ComponentMemoryUsage> memory_usage() const
+            {
+                std::vector<ComponentMemoryUsage> usage;
+                for (const auto& slot : m_componentArrays)
+                {
+                    IComponentArray* component_array = slot.load();
+                    if (component_array)
+                        usage.push_back(component_array->memory_usage());
+                }
+                return usage;
+            }
+
+            /**
+             * @brief Calls `reset` on all Component Arrays which removes all
+             * components.
              */
             void reset()
+            {
+                for (auto& slot : m_componentArrays)
+                {
+                    IComponentArray* component_array = slot.load();
+                    if (component_array) component_array->reset();
+                }
+
+                m_signatures.clear();
+                if (m_signatureIndex) m_signatureIndex->reset();
+                for (auto& cache : m_caches) cache->members.clear();
+                for (auto& group : m_groups) group->len = 0;
+            }
+
+            /**
+             * @brief Copies every populated component array and the length of
+             * every group.
+             *
+             * @param blocks Receives one block per populated array, ordered
+             * by component type.
+             * @param groups Receives the length of each group.
+             */
+            void save(
+                std::vector<ComponentBlock>& blocks, std::vector<size>& groups
+            ) const
             {
                 for (i32 i = 0; i < ecs::MAX_COMPONENTS; i++)
                 {
-                    if (m_componentArrays[i] != nullptr)
-                        m_componentArrays[i]->reset();
+                    IComponentArray* component_array =
+                        m_componentArrays[i].load();
+                    if (component_array == nullptr) continue;
+
+                    ComponentBlock block;
+                    block.type = i;
+                    component_array->save(block);
+                    if (block.len > 0) blocks.push_back(std::move(block));
                 }
+
+                for (const auto& group : m_groups) groups.push_back(group->len);
+            }
+
+            /**
+             * @brief Replaces every component array with blocks saved by
+             * `save`. Arrays without a block are emptied, and blocks of types
+             * never registered in this manager are skipped. Signatures, the
+             * signature index and persistent queries are rebuilt from the
+             * blocks. Every restored component is marked as changed at the
+             * current tick, so `Changed` filters see rolled back values.
+             *
+             * @param blocks Blocks ordered by component type, not delta
+             * encoded.
+             * @param groups Length of each group when the blocks were saved.
+             */
+            void restore(
+                const std::vector<ComponentBlock>& blocks,
+                const std::vector<size>&           groups
+            )
+            {
+                assert(
+                    groups.size() == m_groups.size() &&
+                    "ERROR: Groups were registered after the snapshot was taken"
+                );
+
+                m_signatures.clear();
+
+                size next = 0;
+                for (i32 i = 0; i < ecs::MAX_COMPONENTS; i++)
+                {
+                    // Blocks of unregistered types have no array to load into
+                    while (next < blocks.size() && blocks[next].type < i)
+                        next++;
+
+                    IComponentArray* component_array =
+                        m_componentArrays[i].load();
+                    if (component_array == nullptr) continue;
+
+                    if (next >= blocks.size() || blocks[next].type != i)
+                    {
+                        component_array->reset();
+                        continue;
+                    }
+
+                    const ComponentBlock& block = blocks[next++];
+                    assert(!block.delta && "ERROR: Block is delta encoded");
+                    component_array->load(block, tick());
+
+                    const Entity* entities = (const Entity*)block.bytes.data();
+                    for (size j = 0; j < block.len; j++)
+                        assure_signature(entities[j]).signature.set(i);
+                }
+
+                if (m_signatureIndex)
+                {
+                    m_signatureIndex->reset();
+                    for (const auto& record : m_signatures)
+                    {
+                        if (!record.signature.empty())
+                            m_signatureIndex->update(
+                                record.entity, record.signature
+                            );
+                    }
+                }
+
+                for (auto& cache : m_caches)
+                {
+                    cache->members.clear();
+                    for (const auto& record : m_signatures)
+                    {
+                        if (cache->matches(record.signature))
+                            cache->members.add(record.entity);
+                    }
+                }
+
+                for (size i = 0; i < m_groups.size(); i++)
+                    m_groups[i]->len = groups[i];
             }
         };
     }
@@ -4,11 +4,36 @@ namespace blocs
 {
     namespace ecs
     {
+        /**
+         * Entity handle. The lower 32 bits are the index of the entity and the
+         * upper 32 bits are a version that is incremented every time the
+         * index is recycled, so handles to destroyed entities never match the
+         * entity that reuses their index.
+         */
         using Entity = u64;
 
-        // TODO: implement versioning to prevent errors from accessing data of
-        // deleted entities
         using EntityIndex   = u32;
         using EntityVersion = u32;
+
+        /** Index that does not refer to any entity. */
+        constexpr EntityIndex NULL_INDEX = ~EntityIndex(0);
+
+        /** Handle that does not refer to any entity. */
+        constexpr Entity NULL_ENTITY = ~Entity(0);
+
+        constexpr Entity make_entity(EntityIndex index, EntityVersion version)
+        {
+            return ((Entity)version << 32) | index;
+        }
+
+        constexpr EntityIndex get_index(Entity entity)
+        {
+            return (EntityIndex)(entity & 0xFFFFFFFF);
+        }
+
+        constexpr EntityVersion get_version(Entity entity)
+        {
+            return (EntityVersion)(entity >> 32);
+        }
     }
 }
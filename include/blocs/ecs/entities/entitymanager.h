@@ -1,7 +1,7 @@
 #pragma once
 
-#include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include <blocs/ecs/sparse.h>
 #include <blocs/ecs/entities/entity.h>
@@ -16,87 +16,140 @@ namespace blocs
          */
         struct EntityManager
         {
-            sparse_set<Entity> entities{ecs::MAX_ENTITIES};
-
-            /** Queue of ascending integers representing unused entity id's. */
-            std::queue<Entity> available_entities{};
-            size               num_active_entities{};
-
-            /** Map of entity index to entity name. */
+            /**
+             * Every entity index handed out so far. Slots of active entities
+             * hold the entity itself. Slots of removed entities form an
+             * intrusive free list: their index points to the next free slot
+             * and their version is the version the slot will be reused with.
+             */
+            std::vector<Entity> slots{};
+            /** First slot of the free list. */
+            EntityIndex         free_list = NULL_INDEX;
+            size                num_active_entities{};
+            /** Most entities that can be alive at once. */
+            size                capacity = ecs::MAX_ENTITIES;
+
+            /** Names of entities created or renamed with a name. */
             std::unordered_map<Entity, str> entity_to_name{};
-            /** Map of entity name to entity index. */
+            /** Map of entity name to named entity. */
             std::unordered_map<str, Entity> name_to_entity{};
 
-            EntityManager()
+            /**
+             * @brief Reuses the most recently freed entity index (with its
+             * version incremented) or a new index when none are free.
+             *
+             * @return New `entity`.
+             */
+            Entity allocate()
             {
-                // Initialize the available entities queue with all integers
-                // from 0 to the max # of entities.
-                for (Entity entity = 0; entity < ecs::MAX_ENTITIES; ++entity)
+                Entity entity;
+                if (free_list != NULL_INDEX)
                 {
-                    available_entities.push(entity);
+                    EntityIndex   index   = free_list;
+                    EntityVersion version = get_version(slots[index]);
+
+                    free_list    = get_index(slots[index]);
+                    entity       = make_entity(index, version);
+                    slots[index] = entity;
                 }
+                else
+                {
+                    assert(
+                        slots.size() < capacity &&
+                        "ERROR: max entity limit reached"
+                    );
+                    entity = make_entity((EntityIndex)slots.size(), 0);
+                    slots.push_back(entity);
+                }
+
+                num_active_entities++;
+                return entity;
             }
 
             /**
-             * @brief Adds available entity id to active entities vector
-             * and appears in System component queries next frame.
+             * @brief Creates a named entity. The entity's index is appended to
+             * the name to keep names unique.
              *
-             * @return New `entity` represented by uint32.
+             * @param name Prefix of the entity's name.
+             *
+             * @return New `entity`.
              */
             Entity create(str name)
             {
-                assert(
-                    entities.len + 1 < ecs::MAX_ENTITIES &&
-                    "ERROR: max entity limit reached"
-                );
-                Entity id = available_entities.front();
-                available_entities.pop();
-                num_active_entities++;
+                Entity id = allocate();
 
-                assert(!entities.has(id) && "ERROR: entity already exists");
-                entities.add(id);
-
-                name += std::to_string(id);
-                assert(
-                    name_to_entity.find(name) == name_to_entity.end() &&
-                    "ERROR: cannot have duplicate entity names"
-                );
-                entity_to_name.insert({id, name});
-                name_to_entity.insert({name, id});
+                name += std::to_string(get_index(id));
+                set_name(id, name);
 
                 return id;
             }
 
-            Entity create()
+            /**
+             * @brief Creates an anonymous entity. Does not allocate unless the
+             * slot storage has to grow.
+             *
+             * @return New `entity`.
+             */
+            Entity create() { return allocate(); }
+
+            /**
+             * @brief Creates many anonymous entities at once. Freed indices
+             * are reused first, then the slot storage grows once for the
+             * rest.
+             *
+             * @param count Number of entities to create.
+             *
+             * @return The new entities.
+             */
+            std::vector<Entity> create_batch(size count)
             {
+                std::vector<Entity> entities;
+                entities.reserve(count);
+
+                while (entities.size() < count && free_list != NULL_INDEX)
+                    entities.push_back(allocate());
+
+                size first = slots.size();
+                size added = count - entities.size();
                 assert(
-                    entities.len + 1 < ecs::MAX_ENTITIES &&
+                    first + added <= capacity &&
                     "ERROR: max entity limit reached"
                 );
-                Entity id = available_entities.front();
-                available_entities.pop();
-                num_active_entities++;
 
-                assert(!entities.has(id) && "ERROR: entity already exists");
-                entities.add(id);
+                slots.resize(first + added);
+                for (size i = first; i < first + added; i++)
+                {
+                    slots[i] = make_entity((EntityIndex)i, 0);
+                    entities.push_back(slots[i]);
+                }
 
-                str name = std::to_string(id);
-                assert(
-                    name_to_entity.find(name) == name_to_entity.end() &&
-                    "ERROR: cannot have duplicate entity names"
-                );
-                entity_to_name.insert({id, name});
-                name_to_entity.insert({name, id});
+                num_active_entities += added;
+                return entities;
+            }
 
-                return id;
+            /**
+             * @param entity Entity to check.
+             *
+             * @return Whether the entity has been created and not removed
+             * (false for stale handles to a recycled index).
+             */
+            bool alive(Entity entity) const
+            {
+                EntityIndex index = get_index(entity);
+                return index < slots.size() && slots[index] == entity;
             }
 
             /**
              * @param entity Entity to retrieve name for.
              *
-             * @return Entity name.
+             * @return Entity name, or its index for anonymous entities.
              */
-            str get_name(Entity entity) { return entity_to_name[entity]; }
+            str get_name(Entity entity) const
+            {
+                auto it = entity_to_name.find(entity);
+                if (it != entity_to_name.end()) return it->second;
+                return std::to_string(get_index(entity));
+            }
 
             /**
              * @param name Name of entity to lookup by name.
@@ -111,51 +164,70 @@ namespace blocs
              */
             void set_name(Entity entity, const str& name)
             {
+                assert(
+                    name_to_entity.find(name) == name_to_entity.end() &&
+                    "ERROR: cannot have duplicate entity names"
+                );
+
+                auto prev = entity_to_name.find(entity);
+                if (prev != entity_to_name.end())
+                    name_to_entity.erase(prev->second);
+
                 entity_to_name[entity] = name;
                 name_to_entity[name]   = entity;
             }
 
             /**
-             * @return Key value pairs of all active entities and their names.
+             * @return Key value pairs of all active entities and their names
+             * (anonymous entities are listed by their index).
              */
-            std::unordered_map<Entity, str>& get_all_active_names()
+            std::unordered_map<Entity, str> get_all_active_names() const
             {
-                return entity_to_name;
+                std::unordered_map<Entity, str> names;
+                for (EntityIndex index = 0; index < slots.size(); index++)
+                {
+                    if (get_index(slots[index]) == index)
+                        names.insert({slots[index], get_name(slots[index])});
+                }
+                return names;
             }
 
             /**
-             * @brief Finds and removes an from entity among the active entities
-             * vector and returns the id to the availabe entities queue.
+             * @brief Deactivates an entity and pushes its index onto the free
+             * list with an incremented version.
              *
              * @param entity Entity to be removed.
              */
             void remove(Entity entity)
             {
-                assert(
-                    entity < ecs::MAX_ENTITIES && "ERROR: entity out of range"
-                );
-                assert(entities.has(entity) && "ERROR: entity does not exist");
+                assert(alive(entity) && "ERROR: entity does not exist");
 
-                entities.remove(entity);
+                EntityIndex index = get_index(entity);
+                slots[index] = make_entity(free_list, get_version(entity) + 1);
+                free_list    = index;
 
-                name_to_entity.erase(entity_to_name[entity]);
-                entity_to_name.erase(entity);
+                if (!entity_to_name.empty())
+                {
+                    auto it = entity_to_name.find(entity);
+                    if (it != entity_to_name.end())
+                    {
+                        name_to_entity.erase(it->second);
+                        entity_to_name.erase(it);
+                    }
+                }
 
-                // Return the entity id to back of available queue to be reused
-                // later.
-                available_entities.push(entity);
                 num_active_entities--;
             }
 
-            /** @brief Clears all entities and resets availableEntities queue.
+            /**
+             * @brief Clears all entities. Handles created before the reset
+             * must not be used afterwards.
              */
             void reset()
             {
-                available_entities = {};
-                for (Entity entity = 0; entity < ecs::MAX_ENTITIES; ++entity)
-                    available_entities.push(entity);
+                slots.clear();
+                free_list = NULL_INDEX;
 
-                entities.clear();
                 name_to_entity.clear();
                 entity_to_name.clear();
                 num_active_entities = 0;
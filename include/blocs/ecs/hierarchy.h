@@ -0,0 +1,231 @@
+#pragma once
+
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/math/matrix.h>
+#include <blocs/ecs/world.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Links an entity to its parent and siblings. Children form a
+         * doubly linked list starting at the parent's `first_child`. Use
+         * `set_parent` and `remove_parent` rather than editing the links.
+         */
+        struct Hierarchy
+        {
+            Entity parent       = NULL_ENTITY;
+            Entity first_child  = NULL_ENTITY;
+            Entity next_sibling = NULL_ENTITY;
+            Entity prev_sibling = NULL_ENTITY;
+        };
+
+        /** @brief Transform relative to the entity's parent. */
+        struct LocalTransform
+        {
+            mat4x4f matrix = mat4x4f::identity;
+        };
+
+        /**
+         * @brief Transform relative to the world, computed from the local
+         * transforms of the entity and its ancestors by
+         * `propagate_transforms`. Read it as `const` so reading does not
+         * mark it changed.
+         */
+        struct WorldTransform
+        {
+            mat4x4f matrix = mat4x4f::identity;
+            /**
+             * Tick the matrix was last computed at, or 0 if it never was.
+             * Only `propagate_transforms` writes it, so writing the matrix
+             * elsewhere doesn't hide changes to the local transforms.
+             */
+            Tick    computed = 0;
+        };
+
+        /**
+         * @brief Calls a function with each child of an entity.
+         *
+         * @param func Called with each child, first child first.
+         */
+        template<typename Func>
+        inline void each_child(World& world, Entity parent, Func&& func)
+        {
+            auto* nodes = world.components.get_components<Hierarchy>();
+            if (!nodes->has(parent)) return;
+
+            Entity child = nodes->get(parent).first_child;
+            while (child != NULL_ENTITY)
+            {
+                Entity next = nodes->get(child).next_sibling;
+                func(child);
+                child = next;
+            }
+        }
+
+        /**
+         * @brief Detaches an entity from its parent, making it a root.
+         */
+        inline void remove_parent(World& world, Entity child)
+        {
+            auto* nodes = world.components.get_components<Hierarchy>();
+            if (!nodes->has(child) || nodes->get(child).parent == NULL_ENTITY)
+                return;
+
+            // Marks the child changed so its subtree is recomputed
+            Hierarchy& node = world.components.get<Hierarchy>(child);
+
+            if (node.prev_sibling != NULL_ENTITY)
+                nodes->get(node.prev_sibling).next_sibling = node.next_sibling;
+            else
+                nodes->get(node.parent).first_child = node.next_sibling;
+
+            if (node.next_sibling != NULL_ENTITY)
+                nodes->get(node.next_sibling).prev_sibling = node.prev_sibling;
+
+            node.parent       = NULL_ENTITY;
+            node.next_sibling = NULL_ENTITY;
+            node.prev_sibling = NULL_ENTITY;
+        }
+
+        /**
+         * @brief Makes an entity the first child of another, detaching it
+         * from its previous parent. Adds `Hierarchy` components as needed.
+         *
+         * @return Whether the entity was parented. Parenting an entity to
+         * itself or to one of its descendants would form a cycle, and is
+         * refused without changing anything.
+         */
+        inline bool set_parent(World& world, Entity child, Entity parent)
+        {
+            auto* nodes = world.components.get_components<Hierarchy>();
+            for (Entity ancestor = parent; ancestor != NULL_ENTITY;
+                 ancestor        = nodes->get(ancestor).parent)
+            {
+                if (ancestor == child) return false;
+                if (!nodes->has(ancestor)) break;
+            }
+
+            if (!world.components.has<Hierarchy>(child))
+                world.add_component<Hierarchy>(child);
+            if (!world.components.has<Hierarchy>(parent))
+                world.add_component<Hierarchy>(parent);
+
+            remove_parent(world, child);
+
+            Hierarchy& node = world.components.get<Hierarchy>(child);
+            Hierarchy& head = nodes->get(parent);
+
+            node.parent       = parent;
+            node.next_sibling = head.first_child;
+            if (head.first_child != NULL_ENTITY)
+                nodes->get(head.first_child).prev_sibling = child;
+            head.first_child = child;
+            return true;
+        }
+
+        /**
+         * @brief Destroys an entity and all of its descendants. Destroying an
+         * entity in a hierarchy any other way leaves dangling links.
+         */
+        inline void destroy_recursive(World& world, Entity entity)
+        {
+            remove_parent(world, entity);
+
+            std::vector<Entity> subtree{entity};
+            for (size i = 0; i < subtree.size(); i++)
+            {
+                each_child(
+                    world, subtree[i],
+                    [&](Entity child) { subtree.push_back(child); }
+                );
+            }
+
+            for (Entity member : subtree) world.destroy_entity(member);
+        }
+
+        /**
+         * @brief System that updates `WorldTransform` from `LocalTransform`
+         * for every entity owning both. Hierarchies are walked breadth first
+         * from their roots, so parents are always updated before their
+         * children. Only subtrees whose local transforms or links changed
+         * since their world transform was last computed are recomputed.
+         * Entities missing either transform are skipped with their subtree.
+         */
+        inline void propagate_transforms(World& world)
+        {
+            auto* nodes  = world.components.get_components<Hierarchy>();
+            auto* locals = world.components.get_components<LocalTransform>();
+            auto* worlds = world.components.get_components<WorldTransform>();
+            Tick  tick   = world.components.tick();
+            Tick  oldest = tick - MAX_TICK_AGE;
+
+            constexpr size ROOT = ~size(0);
+
+            struct Pending
+            {
+                Entity entity;
+                /** Index of the parent's world transform. */
+                size   parent;
+                bool   dirty;
+            };
+
+            std::vector<Pending> queue;
+            queue.reserve(worlds->size());
+            for (size i = 0; i < worlds->size(); i++)
+            {
+                Entity entity = worlds->set.dense[i];
+                if (!nodes->has(entity) ||
+                    nodes->get(entity).parent == NULL_ENTITY)
+                    queue.push_back({entity, ROOT, false});
+            }
+
+            for (size head = 0; head < queue.size(); head++)
+            {
+                Pending pending = queue[head];
+                Entity  entity  = pending.entity;
+                if (!locals->has(entity) || !worlds->has(entity)) continue;
+
+                size w = worlds->index(entity);
+                size l = locals->index(entity);
+
+                // Changes made during the tick the matrix was computed at
+                // count, so nothing changed later in that tick is missed
+                WorldTransform& transform = worlds->components[w];
+                Tick computed = clamp_tick(transform.computed, oldest);
+                bool dirty    = pending.dirty || transform.computed == 0 ||
+                             !tick_newer(computed, locals->changed_ticks[l]);
+
+                bool linked = nodes->has(entity);
+                size n      = linked ? nodes->index(entity) : 0;
+                if (linked)
+                    dirty |= !tick_newer(computed, nodes->changed_ticks[n]);
+
+                if (dirty)
+                {
+                    const mat4x4f& local = locals->components[l].matrix;
+                    transform.matrix =
+                        pending.parent == ROOT
+                            ? local
+                            : worlds->components[pending.parent].matrix *
+                                  local;
+                    worlds->changed_ticks[w] = tick;
+                    computed                 = tick;
+                }
+                transform.computed = computed;
+
+                if (!linked) continue;
+
+                Entity child = nodes->components[n].first_child;
+                while (child != NULL_ENTITY)
+                {
+                    queue.push_back({child, w, dirty});
+                    child = nodes->get(child).next_sibling;
+                }
+            }
+        }
+    }
+}
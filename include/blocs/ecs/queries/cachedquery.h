@@ -0,0 +1,70 @@
+#pragma once
+
+#include <blocs/common.h>
+#include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/components/componentmanager.h>
+#include <blocs/ecs/queries/querycache.h>
+#include <blocs/ecs/queries/queryterm.h>
+#include <blocs/ecs/systems/system.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Typed handle to a persistent query. Iterates only the
+         * entities cached as members instead of filtering a component array.
+         *
+         * @tparam T first component type to query for.
+         * @tparam Types other component types and filters to query for.
+         */
+        template<typename T, typename... Types>
+        struct CachedQuery
+        {
+            ComponentManager* components;
+            QueryCache*       cache;
+
+            /** @return Number of entities matching the query. */
+            blocs::size size() const { return cache->members.len; }
+
+            /**
+             * @brief Calls a function on every member of the query that passes
+             * its filters, iterating backwards.
+             *
+             * @param func Called with `(Entity, T&, Types&...)`, without the
+             * filters.
+             */
+            template<typename Func>
+            void each(Func&& func)
+            {
+                auto& members = cache->members;
+                for (auto i = members.len; i-- > 0;)
+                {
+                    auto entity = members.dense[i];
+                    if (!(QueryTerm<Types>::test(*components, entity) && ...))
+                        continue;
+
+                    std::apply(
+                        func, std::tuple_cat(
+                                  std::tuple<Entity>(entity),
+                                  query_fetch<T, Types...>(*components, entity)
+                              )
+                    );
+                }
+            }
+
+            /**
+             * @param func Called on every member of the query, with or
+             * without the entity as its first parameter.
+             */
+            template<typename Func>
+            void query(Func&& func)
+            {
+                each(
+                    [&](Entity entity, auto&&... params)
+                    { query_invoke(func, entity, params...); }
+                );
+            }
+        };
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/components/componentmanager.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /** Default number of entities in a chunk. */
+        constexpr size CHUNK_SIZE = 256;
+
+        /**
+         * @brief Block of entities whose components are stored contiguously,
+         * at the same positions in every queried component array. Lets
+         * systems process components as plain arrays.
+         *
+         * @tparam Types queried component types (`const` for read-only).
+         */
+        template<typename... Types>
+        struct Chunk
+        {
+            const Entity*         entities;
+            size                  count;
+            std::tuple<Types*...> columns;
+
+            /**
+             * @tparam T queried component type.
+             *
+             * @return Components of type T, one per entity in the chunk.
+             */
+            template<typename T>
+            T* get() const
+            {
+                return std::get<T*>(columns);
+            }
+        };
+
+        /**
+         * @brief Scratch copies of the components of a chunk, used when the
+         * queried arrays cannot be aligned.
+         *
+         * @tparam Types queried component types (`const` for read-only).
+         */
+        template<typename... Types>
+        struct ChunkColumns
+        {
+            std::tuple<std::vector<std::remove_const_t<Types>>...> values;
+
+            template<typename T>
+            std::vector<std::remove_const_t<T>>& get()
+            {
+                return std::get<std::vector<std::remove_const_t<T>>>(values);
+            }
+
+            /** @brief Appends copies of an entity's components. */
+            void push(ComponentManager& components, Entity entity)
+            {
+                (get<Types>().push_back(components.get<const Types>(entity)),
+                 ...);
+            }
+
+            /** @return Chunk over the copied components. */
+            Chunk<Types...> chunk(const std::vector<Entity>& entities)
+            {
+                return {
+                    entities.data(), entities.size(), {get<Types>().data()...}};
+            }
+
+            /**
+             * @brief Copies the components not queried as `const` back to
+             * their entities, marking them as changed, and empties every
+             * column.
+             */
+            void write_back(
+                ComponentManager&          components,
+                const std::vector<Entity>& entities
+            )
+            {
+                (write_back_column<Types>(components, entities), ...);
+            }
+
+            template<typename T>
+            void write_back_column(
+                ComponentManager&          components,
+                const std::vector<Entity>& entities
+            )
+            {
+                auto& column = get<T>();
+                if constexpr (!std::is_const_v<T>)
+                {
+                    for (size i = 0; i < entities.size(); i++)
+                        components.get<T>(entities[i]) = column[i];
+                }
+                column.clear();
+            }
+        };
+    }
+}
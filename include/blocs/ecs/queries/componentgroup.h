@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/components/component.h>
+#include <blocs/ecs/components/componentarray.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Owning group of component types. The entities owning every
+         * type in the group are kept at the front of each owned component
+         * array, in the same order, so the arrays can be walked side by side
+         * without looking entities up.
+         */
+        struct ComponentGroup
+        {
+            /** Component types owned by the group. */
+            Signature                     owned;
+            /** Arrays of the owned component types. */
+            std::vector<IComponentArray*> arrays;
+            /** Number of entities in the group, at the front of each array. */
+            size                          len = 0;
+
+            /**
+             * @brief Moves an entity whose signature changed into or out of
+             * the front of the owned arrays. Must be called after components
+             * are inserted and before they are removed.
+             *
+             * @param entity Entity whose components changed.
+             * @param prev Signature before the change.
+             * @param next Signature after the change.
+             */
+            void update(
+                Entity entity, const Signature& prev, const Signature& next
+            )
+            {
+                bool was = prev.contains(owned);
+                bool is  = !next.empty() && next.contains(owned);
+
+                if (!was && is)
+                {
+                    for (auto* array : arrays)
+                        array->swap(array->index(entity), len);
+                    len++;
+                }
+                else if (was && !is)
+                {
+                    len--;
+                    for (auto* array : arrays)
+                        array->swap(array->index(entity), len);
+                }
+            }
+        };
+    }
+}
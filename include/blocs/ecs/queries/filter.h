@@ -0,0 +1,132 @@
+#pragma once
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <blocs/ecs/entities/entity.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Query filter matching entities whose component of type T
+         * changed (or was added) since the running stage last ran. The
+         * component is not passed to the query's function.
+         */
+        template<typename T>
+        struct Changed
+        {
+        };
+
+        /**
+         * @brief Query filter matching entities whose component of type T was
+         * added since the running stage last ran. The component is not passed
+         * to the query's function.
+         */
+        template<typename T>
+        struct Added
+        {
+        };
+
+        /**
+         * @brief Query filter matching entities that own a component of type
+         * T, without passing it to the query's function.
+         */
+        template<typename T>
+        struct With
+        {
+        };
+
+        /**
+         * @brief Query filter rejecting entities that own a component of type
+         * T. Checked against the entity's signature before any component is
+         * fetched.
+         */
+        template<typename T>
+        struct Without
+        {
+        };
+
+        /**
+         * @brief Queries a component of type T without requiring it. The
+         * query's function is passed a pointer to the component, or `nullptr`
+         * if the entity doesn't own one.
+         */
+        template<typename T>
+        struct Optional
+        {
+        };
+
+        /**
+         * @brief Parameters passed to a query's function for a queried type.
+         * Components are passed by reference and filters are not passed.
+         */
+        template<typename T>
+        struct query_param
+        {
+            using type = std::tuple<T&>;
+        };
+
+        template<typename T>
+        struct query_param<Changed<T>>
+        {
+            using type = std::tuple<>;
+        };
+
+        template<typename T>
+        struct query_param<Added<T>>
+        {
+            using type = std::tuple<>;
+        };
+
+        template<typename T>
+        struct query_param<With<T>>
+        {
+            using type = std::tuple<>;
+        };
+
+        template<typename T>
+        struct query_param<Without<T>>
+        {
+            using type = std::tuple<>;
+        };
+
+        template<typename T>
+        struct query_param<Optional<T>>
+        {
+            using type = std::tuple<T*>;
+        };
+
+        /** Tuple of the parameters passed for every queried type. */
+        template<typename... Types>
+        using query_params = decltype(std::tuple_cat(
+            std::declval<typename query_param<Types>::type>()...
+        ));
+
+        template<typename Params>
+        struct query_function;
+
+        template<typename... Params>
+        struct query_function<std::tuple<Params...>>
+        {
+            using type        = std::function<void(Params...)>;
+            using with_entity = std::function<void(Entity, Params...)>;
+        };
+
+        /**
+         * @brief Calls a query's function with the parameters fetched for an
+         * entity, passing the entity first if the function accepts it.
+         */
+        template<typename Func, typename... Params>
+        inline void query_invoke(Func& func, Entity entity, Params&&... params)
+        {
+            if constexpr (std::is_invocable_v<Func&, Entity, Params...>)
+                func(entity, std::forward<Params>(params)...);
+            else
+                func(std::forward<Params>(params)...);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <blocs/common.h>
+#include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/components/componentmanager.h>
+#include <blocs/ecs/queries/componentgroup.h>
+#include <blocs/ecs/queries/queryterm.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Typed handle to an owning group. Iterating it walks the
+         * front of every owned component array by index, with no lookups.
+         *
+         * @tparam T first component type owned by the group.
+         * @tparam Types other component types owned by the group.
+         */
+        template<typename T, typename... Types>
+        struct Group
+        {
+            static_assert(
+                is_component_term<T> && (is_component_term<Types> && ...) &&
+                "ERROR: groups can only own components"
+            );
+
+            ComponentManager* components;
+            ComponentGroup*   group;
+
+            /** @return Number of entities owning every component type. */
+            blocs::size size() const { return group->len; }
+
+            /**
+             * @brief Calls a function on every member of the group, iterating
+             * backwards.
+             *
+             * @param func Called with `(Entity, T&, Types&...)`.
+             */
+            template<typename Func>
+            void each(Func&& func)
+            {
+                auto& entities = components->get_components<T>()->set.dense;
+                for (auto i = group->len; i-- > 0;)
+                {
+                    auto entity = entities[i];
+                    std::apply(
+                        func,
+                        std::tuple_cat(
+                            std::tuple<Entity>(entity),
+                            query_fetch_at<T>(*components, entity, i),
+                            query_fetch_at<Types>(*components, entity, i)...
+                        )
+                    );
+                }
+            }
+
+            /**
+             * @param func Called on every member of the group, with or
+             * without the entity as its first parameter.
+             */
+            template<typename Func>
+            void query(Func&& func)
+            {
+                each(
+                    [&](Entity entity, auto&&... params)
+                    { query_invoke(func, entity, params...); }
+                );
+            }
+        };
+    }
+}
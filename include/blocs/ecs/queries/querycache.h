@@ -0,0 +1,73 @@
+#pragma once
+
+#include <blocs/common.h>
+#include <blocs/ecs/sparse.h>
+#include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/components/component.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Component types an entity must own, and must not own, to
+         * match a query.
+         */
+        struct QueryMask
+        {
+            Signature include;
+            Signature exclude;
+
+            bool matches(const Signature& signature) const
+            {
+                return signature.contains(include) &&
+                       !signature.intersects(exclude);
+            }
+
+            bool operator==(const QueryMask& other) const
+            {
+                return include == other.include && exclude == other.exclude;
+            }
+        };
+
+        /**
+         * @brief Persistent list of the entities matching a set of component
+         * types. Updated incrementally whenever an entity's signature changes
+         * instead of being rediscovered on every query.
+         */
+        struct QueryCache
+        {
+            /** Component types that decide whether an entity is a member. */
+            QueryMask          mask;
+            /** Entities currently matching the query. */
+            sparse_set<Entity> members{ecs::MAX_ENTITIES};
+
+            QueryCache(const QueryMask& mask) : mask(mask) {}
+
+            bool matches(const Signature& signature) const
+            {
+                return !signature.empty() && mask.matches(signature);
+            }
+
+            /**
+             * @brief Adds or removes an entity whose signature changed.
+             *
+             * @param entity Entity whose components changed.
+             * @param prev Signature before the change.
+             * @param next Signature after the change.
+             */
+            void update(
+                Entity entity, const Signature& prev, const Signature& next
+            )
+            {
+                bool was = matches(prev);
+                bool is  = matches(next);
+
+                if (!was && is)
+                    members.add(entity);
+                else if (was && !is)
+                    members.remove(entity);
+            }
+        };
+    }
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
+
+#include <blocs/common.h>
+#include <blocs/ecs/sparse.h>
+#include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/components/component.h>
+#include <blocs/ecs/components/componentmanager.h>
+#include <blocs/ecs/queries/querycache.h>
+#include <blocs/ecs/queries/filter.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Describes how a type in a query's type list is matched and
+         * passed to the query's function. A component type is required and
+         * passed by reference. Passing it as `const` skips marking the
+         * component as changed.
+         *
+         * @tparam T type of component, or a filter.
+         */
+        template<typename T>
+        struct QueryTerm
+        {
+            using Component = std::remove_const_t<T>;
+
+            static void mask(ComponentManager& components, QueryMask& mask)
+            {
+                mask.include.set(components.get_type_id<T>());
+            }
+
+            /** @return Entities owning the component, or `nullptr`. */
+            static sparse_set<Entity>* set(ComponentManager& components)
+            {
+                return &components.get_components<T>()->set;
+            }
+
+            /**
+             * @return Whether an entity owning the term's components passes
+             * its checks beyond the signature.
+             */
+            static bool test(ComponentManager&, Entity) { return true; }
+
+            static std::tuple<T&> fetch(
+                ComponentManager& components, Entity entity
+            )
+            {
+                return {components.get<T>(entity)};
+            }
+
+            /**
+             * @brief Marks a range of packed components as changed, unless T
+             * is `const`.
+             */
+            static void mark_changed(
+                ComponentManager& components, size begin, size end
+            )
+            {
+                if constexpr (!std::is_const_v<T>)
+                {
+                    auto& ticks = components.get_components<T>()->changed_ticks;
+                    std::fill(
+                        ticks.begin() + begin, ticks.begin() + end,
+                        components.tick()
+                    );
+                }
+            }
+
+            /**
+             * @brief Fetches a component by its packed index, skipping the
+             * entity lookup.
+             */
+            static std::tuple<T&> fetch_at(
+                ComponentManager&          components,
+                ComponentArray<Component>& component_array, size index
+            )
+            {
+                if constexpr (!std::is_const_v<T>)
+                    component_array.changed_ticks[index] = components.tick();
+
+                return {component_array.at(index)};
+            }
+        };
+
+        template<typename T>
+        struct QueryTerm<Changed<T>>
+        {
+            static void mask(ComponentManager& components, QueryMask& mask)
+            {
+                mask.include.set(components.get_type_id<T>());
+            }
+
+            static sparse_set<Entity>* set(ComponentManager& components)
+            {
+                return &components.get_components<T>()->set;
+            }
+
+            static bool test(ComponentManager& components, Entity entity)
+            {
+                return tick_newer(
+                    components.get_components<T>()->changed_tick(entity),
+                    components.last_tick()
+                );
+            }
+
+            static std::tuple<> fetch(ComponentManager&, Entity) { return {}; }
+        };
+
+        template<typename T>
+        struct QueryTerm<Added<T>>
+        {
+            static void mask(ComponentManager& components, QueryMask& mask)
+            {
+                mask.include.set(components.get_type_id<T>());
+            }
+
+            static sparse_set<Entity>* set(ComponentManager& components)
+            {
+                return &components.get_components<T>()->set;
+            }
+
+            static bool test(ComponentManager& components, Entity entity)
+            {
+                return tick_newer(
+                    components.get_components<T>()->added_tick(entity),
+                    components.last_tick()
+                );
+            }
+
+            static std::tuple<> fetch(ComponentManager&, Entity) { return {}; }
+        };
+
+        template<typename T>
+        struct QueryTerm<With<T>>
+        {
+            static void mask(ComponentManager& components, QueryMask& mask)
+            {
+                mask.include.set(components.get_type_id<T>());
+            }
+
+            static sparse_set<Entity>* set(ComponentManager& components)
+            {
+                return &components.get_components<T>()->set;
+            }
+
+            static bool test(ComponentManager&, Entity) { return true; }
+
+            static std::tuple<> fetch(ComponentManager&, Entity) { return {}; }
+        };
+
+        template<typename T>
+        struct QueryTerm<Without<T>>
+        {
+            static void mask(ComponentManager& components, QueryMask& mask)
+            {
+                mask.exclude.set(components.get_type_id<T>());
+            }
+
+            static sparse_set<Entity>* set(ComponentManager&)
+            {
+                return nullptr;
+            }
+
+            static bool test(ComponentManager&, Entity) { return true; }
+
+            static std::tuple<> fetch(ComponentManager&, Entity) { return {}; }
+        };
+
+        template<typename T>
+        struct QueryTerm<Optional<T>>
+        {
+            static void mask(ComponentManager&, QueryMask&) {}
+
+            static sparse_set<Entity>* set(ComponentManager&)
+            {
+                return nullptr;
+            }
+
+            static bool test(ComponentManager&, Entity) { return true; }
+
+            static std::tuple<T*> fetch(
+                ComponentManager& components, Entity entity
+            )
+            {
+                auto* component_array = components.get_components<T>();
+                if (!component_array->has(entity)) return {nullptr};
+
+                return {&components.get<T>(entity)};
+            }
+        };
+
+        /**
+         * @tparam Types queried types.
+         *
+         * @return Mask of the component types required and excluded by a
+         * query.
+         */
+        template<typename... Types>
+        QueryMask query_mask(ComponentManager& components)
+        {
+            QueryMask mask;
+            (QueryTerm<Types>::mask(components, mask), ...);
+            return mask;
+        }
+
+        /**
+         * @tparam Types queried types.
+         *
+         * @return Whether an entity matches every queried type.
+         */
+        template<typename... Types>
+        bool query_matches(
+            ComponentManager& components, const QueryMask& mask, Entity entity
+        )
+        {
+            return mask.matches(components.get_signature(entity)) &&
+                   (QueryTerm<Types>::test(components, entity) && ...);
+        }
+
+        /**
+         * @tparam Types queried types.
+         *
+         * @return Parameters passed to the query's function for an entity.
+         */
+        template<typename... Types>
+        query_params<Types...> query_fetch(
+            [[maybe_unused]] ComponentManager& components,
+            [[maybe_unused]] Entity            entity
+        )
+        {
+            return std::tuple_cat(
+                QueryTerm<Types>::fetch(components, entity)...
+            );
+        }
+
+        /**
+         * Whether a queried type is a component passed by reference rather
+         * than a filter.
+         */
+        template<typename T>
+        constexpr bool is_component_term =
+            std::is_same_v<query_params<T>, std::tuple<T&>>;
+
+        /**
+         * @brief Fetches the parameters of a queried type for an entity
+         * stored at a known index of every queried component array, such as a
+         * member of an owning group. Filters are fetched by entity.
+         *
+         * @tparam T queried type.
+         */
+        template<typename T>
+        auto query_fetch_at(
+            ComponentManager& components, Entity entity, size index
+        )
+        {
+            if constexpr (is_component_term<T>)
+            {
+                return QueryTerm<T>::fetch_at(
+                    components, *components.get_components<T>(), index
+                );
+            }
+            else
+                return QueryTerm<T>::fetch(components, entity);
+        }
+
+        /**
+         * @tparam Types queried types.
+         *
+         * @return Entity set of the required component with the fewest
+         * entities (the first type wins ties).
+         */
+        template<typename... Types>
+        sparse_set<Entity>* query_smallest_set(ComponentManager& components)
+        {
+            sparse_set<Entity>* sets[] = {QueryTerm<Types>::set(components)...};
+
+            sparse_set<Entity>* smallest = nullptr;
+            for (auto* set : sets)
+            {
+                if (set && (!smallest || set->len < smallest->len))
+                    smallest = set;
+            }
+            return smallest;
+        }
+    }
+}
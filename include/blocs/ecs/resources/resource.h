@@ -1,9 +1,76 @@
 #pragma once
 
+#include <atomic>
+#include <limits>
+#include <mutex>
+
+#include <blocs/common.h>
+
 namespace blocs
 {
     namespace ecs
     {
         using Resource = void*;
+
+        /** Number of resource type ids, one per value of a `u8`. */
+        constexpr size MAX_RESOURCES = std::numeric_limits<u8>::max() + 1;
+
+        /**
+         * @return Next unused resource type id. Ids are shared by every
+         * world.
+         */
+        inline u8 next_resource_type()
+        {
+            static std::atomic<u32> s_next{0};
+
+            u32 next = s_next++;
+            assert(
+                next < MAX_RESOURCES &&
+                "ERROR: exceeded the maximum number of resource types"
+            );
+            return (u8)next;
+        }
+
+        /**
+         * @brief Id of a resource type plus one, or 0 until assigned.
+         * Constant initialized, so reading it needs no guard.
+         */
+        template<typename T>
+        inline constinit std::atomic<u32> resource_type_slot{0};
+
+        /**
+         * @brief Assigns an id to a resource type that has none yet.
+         *
+         * @param slot Id slot of the resource type.
+         *
+         * @return Id of the resource type plus one.
+         */
+        inline u32 assign_resource_type(std::atomic<u32>& slot)
+        {
+            static constinit std::mutex s_mutex;
+
+            std::lock_guard<std::mutex> lock(s_mutex);
+            u32 id = slot.load(std::memory_order_relaxed);
+            if (id == 0)
+            {
+                id = next_resource_type() + 1;
+                slot.store(id, std::memory_order_relaxed);
+            }
+            return id;
+        }
+
+        /**
+         * @return Id of a resource type, assigned the first time it is asked
+         * for and the same in every world. Each later call is a single
+         * relaxed load.
+         */
+        template<typename T>
+        inline u8 resource_type()
+        {
+            u32 id = resource_type_slot<T>.load(std::memory_order_relaxed);
+            if (id == 0) [[unlikely]]
+                id = assign_resource_type(resource_type_slot<T>);
+            return (u8)(id - 1);
+        }
     }
 }
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <unordered_map>
+#include <type_traits>
 
 #include <blocs/common.h>
 #include <blocs/ecs/resources/resource.h>
@@ -9,25 +9,108 @@ namespace blocs
 {
     namespace ecs
     {
+        /** A resource and how to reset and delete it. */
+        struct ResourceSlot
+        {
+            Resource resource         = nullptr;
+            void (*reset)(Resource)   = nullptr;
+            void (*destroy)(Resource) = nullptr;
+
+            /** Whether the manager created the resource and deletes it. */
+            bool owned = false;
+        };
+
+        /**
+         * @brief Typed pointer to a resource, looked up once and cached by
+         * systems that access the resource every frame. Follows the
+         * resource if it is added or replaced later.
+         *
+         * @tparam T type of the resource.
+         */
+        template<typename T>
+        class ResourceRef
+        {
+        private:
+            const ResourceSlot* m_slot = nullptr;
+
+        public:
+            ResourceRef() = default;
+            explicit ResourceRef(const ResourceSlot* slot) : m_slot(slot) {}
+
+            /** @return The resource, or `nullptr` if it isn't added. */
+            T* get() const { return (T*)m_slot->resource; }
+
+            T* operator->() const { return get(); }
+            T& operator*() const { return *get(); }
+
+            explicit operator bool() const { return get() != nullptr; }
+        };
+
         /**
          * @brief Manages the registration and retrieval of
          * global unique data containers.
+         *
+         * Resources constructed by `add<T>(args...)` are owned by the
+         * manager and deleted with it. Resources passed in by pointer stay
+         * owned by the caller, who must keep them alive while they are
+         * added.
          */
         class ResourceManager
         {
         private:
-            std::unordered_map<u8, Resource> m_resources;
-            u8                               m_nextResourceType = 0;
+            /**
+             * Resources indexed by their type id. Slots never move, so
+             * `ResourceRef`s stay valid for the lifetime of the manager.
+             */
+            ResourceSlot m_resources[MAX_RESOURCES];
 
             template<typename T>
-            inline u8 get_type_id()
+            static inline u8 get_type_id()
             {
-                static u8 s_resource = ++m_nextResourceType;
-                return s_resource;
+                return resource_type<T>();
+            }
+
+            /** @brief Deletes the resource of a slot if the manager owns it. */
+            static void release(ResourceSlot& slot)
+            {
+                if (slot.resource && slot.owned) slot.destroy(slot.resource);
+                slot.owned = false;
+            }
+
+            template<typename T>
+            T* insert(T* resource, bool owned)
+            {
+                ResourceSlot& slot = m_resources[get_type_id<T>()];
+                assert(
+                    slot.resource == nullptr &&
+                    "ERROR: already registered resource"
+                );
+
+                slot.resource = resource;
+                slot.owned    = owned;
+                slot.destroy  = [](Resource resource) { delete (T*)resource; };
+                if constexpr (std::is_default_constructible_v<T> &&
+                              std::is_move_assignable_v<T>)
+                    slot.reset = [](Resource resource) { *(T*)resource = T{}; };
+
+                return resource;
             }
 
         public:
+            ResourceManager() = default;
+
+            ResourceManager(const ResourceManager&)            = delete;
+            ResourceManager& operator=(const ResourceManager&) = delete;
+
+            ~ResourceManager()
+            {
+                for (auto& slot : m_resources) release(slot);
+            }
+
             /**
+             * @brief Adds a resource owned by the caller. The manager never
+             * deletes it.
+             *
              * @tparam T type of resource to add (automatically inferred from
              * resource parameter).
              * @param resource resouce to add.
@@ -35,16 +118,13 @@ namespace blocs
             template<typename T>
             T* add(T* resource)
             {
-                u8 type = get_type_id<T>();
-                assert(
-                    m_resources.find(type) == m_resources.end() &&
-                    "ERROR: already registered resource"
-                );
-                m_resources.insert({type, resource});
-                return resource;
+                return insert(resource, false);
             }
 
             /**
+             * @brief Constructs a resource owned by the manager, deleted along
+             * with it.
+             *
              * @tparam T type of resource to add.
              * @tparam Args types of resource arguments (inferred from members
              * of T).
@@ -54,21 +134,22 @@ namespace blocs
             template<typename T, typename... Args>
             T* add(Args&&... args)
             {
-                return add(new T(args...));
+                return insert(new T(args...), true);
             }
 
+            /**
+             * @brief Replaces a resource with one owned by the caller. The
+             * previous resource is deleted if the manager owned it.
+             */
             template<typename T>
             T* replace(T* resource)
             {
-                u8 type = get_type_id<T>();
-                assert(
-                    m_resources.find(type) != m_resources.end() &&
-                    "ERROR: could not find requested resource"
-                );
-                auto prev         = (T*)m_resources[type];
-                m_resources[type] = resource;
-                delete prev;
-                return (T*)m_resources[type];
+                assert(has<T>() && "ERROR: could not find requested resource");
+
+                ResourceSlot& slot = m_resources[get_type_id<T>()];
+                release(slot);
+                slot.resource = resource;
+                return resource;
             }
 
             /**
@@ -79,30 +160,38 @@ namespace blocs
             template<typename T>
             T* get()
             {
-                u8 type = get_type_id<T>();
-                assert(
-                    m_resources.find(type) != m_resources.end() &&
-                    "ERROR: could not find requested resource"
-                );
-                return (T*)m_resources[type];
+                assert(has<T>() && "ERROR: could not find requested resource");
+                return (T*)m_resources[get_type_id<T>()].resource;
+            }
+
+            /**
+             * @tparam T type of resource to access.
+             *
+             * @return Cached pointer to the resource, valid for the lifetime
+             * of the manager even if the resource is not added yet.
+             */
+            template<typename T>
+            ResourceRef<T> ref() const
+            {
+                return ResourceRef<T>(&m_resources[get_type_id<T>()]);
             }
 
             template<typename T>
             bool has() const
             {
-                u8 type = get_type_id<T>();
-                return m_resources.find(type) != m_resources.end();
+                return m_resources[get_type_id<T>()].resource != nullptr;
             }
 
             /**
              * @brief Resets all registered resources to their default values.
-             * Does not remove or unregister resources.
+             * Does not remove or unregister resources. Resources that cannot
+             * be default constructed and assigned are left unchanged.
              */
             void reset()
             {
-                for (auto [type, resource] : m_resources)
+                for (auto& slot : m_resources)
                 {
-                    resource = {};
+                    if (slot.resource && slot.reset) slot.reset(slot.resource);
                 }
             }
         };
@@ -0,0 +1,415 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/math/vec.h>
+#include <blocs/math/shapes.h>
+#include <blocs/ecs/world.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Spatial index of the entities owning a component, stored as
+         * a resource. Space is split into square cells and every entity is
+         * listed in each cell its bounds overlap, so range queries and
+         * broadphase collision only compare entities sharing cells.
+         *
+         * @tparam T Component the bounds of each entity are read from.
+         */
+        template<typename T>
+        class SpatialHash
+        {
+        public:
+            /** Returns the area covered by an entity's component. */
+            using Bounds = rectf (*)(const T& component);
+
+        private:
+            /** Inclusive range of cells. */
+            struct Cells
+            {
+                i32 x0, y0;
+                i32 x1, y1;
+
+                bool operator==(const Cells& other) const
+                {
+                    return x0 == other.x0 && y0 == other.y0 &&
+                           x1 == other.x1 && y1 == other.y1;
+                }
+
+                size count() const
+                {
+                    return (size)(x1 - x0 + 1) * (size)(y1 - y0 + 1);
+                }
+            };
+
+            struct Entry
+            {
+                rectf bounds;
+                Cells cells;
+            };
+
+            f32    m_cellSize;
+            Bounds m_bounds;
+
+            /** Indexed entities, in the same order as `m_entries`. */
+            sparse_set<Entity> m_set{ecs::MAX_ENTITIES};
+            std::vector<Entry> m_entries;
+
+            /** Entities overlapping each occupied cell. */
+            std::unordered_map<u64, std::vector<Entity>> m_cells;
+
+            /** Changes at or after this tick are picked up by `update`. */
+            Tick m_lastTick = 0;
+
+            static u64 key(i32 x, i32 y)
+            {
+                return ((u64)(u32)x << 32) | (u32)y;
+            }
+
+            i32 cell(f32 value) const
+            {
+                return (i32)std::floor(value / m_cellSize);
+            }
+
+            Cells cells_of(const rectf& bounds) const
+            {
+                return {
+                    cell(bounds.x), cell(bounds.y), cell(bounds.x + bounds.w),
+                    cell(bounds.y + bounds.h)};
+            }
+
+            const Entry& entry(Entity entity) const
+            {
+                return m_entries[m_set.index(entity)];
+            }
+
+            void link(Entity entity, const Cells& cells)
+            {
+                for (i32 y = cells.y0; y <= cells.y1; y++)
+                {
+                    for (i32 x = cells.x0; x <= cells.x1; x++)
+                        m_cells[key(x, y)].push_back(entity);
+                }
+            }
+
+            void unlink(Entity entity, const Cells& cells)
+            {
+                for (i32 y = cells.y0; y <= cells.y1; y++)
+                {
+                    for (i32 x = cells.x0; x <= cells.x1; x++)
+                    {
+                        auto  it   = m_cells.find(key(x, y));
+                        auto& list = it->second;
+
+                        *std::find(list.begin(), list.end(), entity) =
+                            list.back();
+                        list.pop_back();
+                        if (list.empty()) m_cells.erase(it);
+                    }
+                }
+            }
+
+            /** @return Squared distance from a point to the closest edge. */
+            static f32 distance_squared(const rectf& bounds, const vec2f& point)
+            {
+                f32 dx = std::max({bounds.x - point.x, 0.0f,
+                                   point.x - (bounds.x + bounds.w)});
+                f32 dy = std::max({bounds.y - point.y, 0.0f,
+                                   point.y - (bounds.y + bounds.h)});
+                return dx * dx + dy * dy;
+            }
+
+        public:
+            /**
+             * @param cell_size Width and height of a cell. Around the size of
+             * a typical entity works best.
+             * @param bounds Returns the area covered by an entity's component.
+             */
+            SpatialHash(f32 cell_size, Bounds bounds)
+                : m_cellSize(cell_size), m_bounds(bounds)
+            {
+                assert(cell_size > 0 && "ERROR: cell size must be positive");
+            }
+
+            /**
+             * @brief Brings the index up to date with the world. Only
+             * components changed or added since the last update are rehashed,
+             * and entities that lost the component are dropped.
+             */
+            void update(World& world)
+            {
+                auto* array = world.components.get_components<T>();
+
+                for (auto i = m_set.len; i-- > 0;)
+                {
+                    Entity entity = m_set.dense[i];
+                    if (!array->has(entity)) remove(entity);
+                }
+
+                for (size i = 0; i < array->size(); i++)
+                {
+                    Entity entity = array->set.dense[i];
+                    if (!tick_newer(m_lastTick, array->changed_ticks[i]) ||
+                        !m_set.has(entity))
+                        insert(entity, m_bounds(array->components[i]));
+                }
+
+                // Changes made later in the current tick are picked up next
+                m_lastTick = world.components.tick();
+            }
+
+            /**
+             * @brief Adds an entity or moves it to new bounds. Cells are only
+             * relinked when the bounds cross into different cells.
+             */
+            void insert(Entity entity, const rectf& bounds)
+            {
+                Cells cells = cells_of(bounds);
+
+                if (m_set.has(entity))
+                {
+                    Entry& entry = m_entries[m_set.index(entity)];
+                    if (!(entry.cells == cells))
+                    {
+                        unlink(entity, entry.cells);
+                        link(entity, cells);
+                    }
+                    entry = {bounds, cells};
+                    return;
+                }
+
+                m_set.add(entity);
+                m_entries.push_back({bounds, cells});
+                link(entity, cells);
+            }
+
+            void remove(Entity entity)
+            {
+                if (!m_set.has(entity)) return;
+
+                auto index = m_set.index(entity);
+                unlink(entity, m_entries[index].cells);
+
+                m_entries[index] = m_entries.back();
+                m_entries.pop_back();
+                m_set.remove(entity);
+            }
+
+            void clear()
+            {
+                m_set.clear();
+                m_entries.clear();
+                m_cells.clear();
+                m_lastTick = 0;
+            }
+
+            bool has(Entity entity) const { return m_set.has(entity); }
+
+            /** @return Number of indexed entities. */
+            size count() const { return m_entries.size(); }
+
+            /** @return Bounds an entity was last indexed with. */
+            const rectf& bounds(Entity entity) const
+            {
+                assert(has(entity) && "ERROR: entity is not indexed");
+                return entry(entity).bounds;
+            }
+
+            /**
+             * @brief Calls a function once for every entity whose bounds
+             * intersect an area.
+             *
+             * @param area Area to search.
+             * @param func Called with each entity found.
+             */
+            template<typename Func>
+            void query(const rectf& area, Func&& func) const
+            {
+                Cells range = cells_of(area);
+
+                // Scanning every entity is cheaper than visiting empty cells
+                if (range.count() > m_entries.size())
+                {
+                    for (size i = 0; i < m_entries.size(); i++)
+                    {
+                        if (m_entries[i].bounds.intersects(area))
+                            func(m_set.dense[i]);
+                    }
+                    return;
+                }
+
+                for (i32 y = range.y0; y <= range.y1; y++)
+                {
+                    for (i32 x = range.x0; x <= range.x1; x++)
+                    {
+                        auto it = m_cells.find(key(x, y));
+                        if (it == m_cells.end()) continue;
+
+                        for (Entity entity : it->second)
+                        {
+                            const Entry& found = entry(entity);
+
+                            // Report each entity from the first shared cell
+                            if (x != std::max(found.cells.x0, range.x0) ||
+                                y != std::max(found.cells.y0, range.y0))
+                                continue;
+
+                            if (found.bounds.intersects(area)) func(entity);
+                        }
+                    }
+                }
+            }
+
+            /**
+             * @brief Calls a function once for every entity whose bounds
+             * intersect a circle.
+             */
+            template<typename Func>
+            void query(const circlef& area, Func&& func) const
+            {
+                rectf box(
+                    area.center.x - area.radius, area.center.y - area.radius,
+                    area.radius * 2, area.radius * 2
+                );
+                f32 radius = area.radius * area.radius;
+
+                query(
+                    box,
+                    [&](Entity entity)
+                    {
+                        const rectf& bounds = entry(entity).bounds;
+                        if (distance_squared(bounds, area.center) <= radius)
+                            func(entity);
+                    }
+                );
+            }
+
+            /** @return Entities whose bounds intersect an area. */
+            template<typename Area>
+            std::vector<Entity> query(const Area& area) const
+            {
+                std::vector<Entity> found;
+                query(area, [&](Entity entity) { found.push_back(entity); });
+                return found;
+            }
+
+            /**
+             * @brief Finds the entity whose bounds are closest to a point.
+             * Cells are searched in rings around the point, stopping once no
+             * closer entity can remain.
+             *
+             * @param point Point to search from.
+             * @param max_distance Entities further away are ignored.
+             * @param result Set to the closest entity, if one was found.
+             *
+             * @return Whether an entity was found.
+             */
+            bool nearest(
+                const vec2f& point, f32 max_distance, Entity& result
+            ) const
+            {
+                f32  best  = max_distance * max_distance;
+                bool found = false;
+
+                auto visit = [&](Entity entity, const rectf& bounds)
+                {
+                    f32 distance = distance_squared(bounds, point);
+                    if (distance <= best)
+                    {
+                        best    = distance;
+                        result  = entity;
+                        found   = true;
+                    }
+                };
+
+                // Scanning every entity is cheaper than visiting empty cells
+                f32 reach = std::ceil(max_distance / m_cellSize) + 1;
+                if ((reach * 2 + 1) * (reach * 2 + 1) > m_entries.size())
+                {
+                    for (size i = 0; i < m_entries.size(); i++)
+                        visit(m_set.dense[i], m_entries[i].bounds);
+                    return found;
+                }
+
+                i32  cx         = cell(point.x);
+                i32  cy         = cell(point.y);
+                auto visit_cell = [&](i32 x, i32 y)
+                {
+                    auto it = m_cells.find(key(x, y));
+                    if (it == m_cells.end()) return;
+
+                    for (Entity entity : it->second)
+                        visit(entity, entry(entity).bounds);
+                };
+
+                for (i32 r = 0; r <= (i32)reach; r++)
+                {
+                    for (i32 x = cx - r; x <= cx + r; x++)
+                    {
+                        visit_cell(x, cy - r);
+                        if (r > 0) visit_cell(x, cy + r);
+                    }
+                    for (i32 y = cy - r + 1; y <= cy + r - 1; y++)
+                    {
+                        visit_cell(cx - r, y);
+                        visit_cell(cx + r, y);
+                    }
+
+                    // Cells on the next ring are at least r cells away
+                    f32 ring = r * m_cellSize;
+                    if (found && best <= ring * ring) break;
+                }
+
+                return found;
+            }
+
+            /**
+             * @brief Calls a function once for every pair of entities whose
+             * bounds intersect, for use as a collision broadphase.
+             *
+             * @param func Called with the two entities of each pair.
+             */
+            template<typename Func>
+            void pairs(Func&& func) const
+            {
+                for (const auto& [cell_key, list] : m_cells)
+                {
+                    i32 x = (i32)(u32)(cell_key >> 32);
+                    i32 y = (i32)(u32)cell_key;
+
+                    for (size i = 0; i < list.size(); i++)
+                    {
+                        const Entry& a = entry(list[i]);
+                        for (size j = i + 1; j < list.size(); j++)
+                        {
+                            const Entry& b = entry(list[j]);
+
+                            // Report each pair from the first shared cell
+                            if (x != std::max(a.cells.x0, b.cells.x0) ||
+                                y != std::max(a.cells.y0, b.cells.y0))
+                                continue;
+
+                            if (a.bounds.intersects(b.bounds))
+                                func(list[i], list[j]);
+                        }
+                    }
+                }
+            }
+
+            /** @return Every pair of entities whose bounds intersect. */
+            std::vector<std::pair<Entity, Entity>> pairs() const
+            {
+                std::vector<std::pair<Entity, Entity>> found;
+                pairs([&](Entity a, Entity b) { found.push_back({a, b}); });
+                return found;
+            }
+        };
+    }
+}
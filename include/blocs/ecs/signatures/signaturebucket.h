@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+#include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/components/component.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief List of every entity that owns exactly the same set of
+         * component types. Only the entities are listed: their components
+         * stay in each type's `ComponentArray`.
+         */
+        struct SignatureBucket
+        {
+            /** Component types owned by every entity in the bucket. */
+            Signature           signature;
+            /** Packed list of the entities in the bucket. */
+            std::vector<Entity> entities{};
+
+            blocs::size size() const { return entities.size(); }
+        };
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/components/component.h>
+#include <blocs/ecs/signatures/signaturebucket.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Index of entities by component signature. Entities owning
+         * the same component types share a bucket, so multi-component queries
+         * only visit the entities of buckets that match instead of checking
+         * every entity of the smallest array. Buckets hold entities, not
+         * component columns.
+         */
+        struct SignatureIndex
+        {
+            /** Location of an entity within the buckets. */
+            struct Record
+            {
+                static constexpr u32 NONE = ~0U;
+
+                u32 bucket = NONE;
+                u32 row       = 0;
+            };
+
+            std::vector<SignatureBucket> buckets{};
+            std::unordered_map<Signature, u32, Signature::Hash> lookup{};
+
+            /** Bucket location of every entity, indexed by entity index. */
+            std::vector<Record> records{};
+
+            /**
+             * @brief Moves an entity to the bucket matching its new signature.
+             * Entities without any components are not kept in a bucket.
+             *
+             * @param entity Entity whose components changed.
+             * @param signature Component types now owned by the entity.
+             */
+            void update(Entity entity, const Signature& signature)
+            {
+                EntityIndex index = get_index(entity);
+                if (index >= records.size()) records.resize(index + 1);
+                Record& record = records[index];
+
+                // Swap-and-pop the entity out of its previous bucket
+                if (record.bucket != Record::NONE)
+                {
+                    auto& entities = buckets[record.bucket].entities;
+                    Entity last    = entities.back();
+
+                    entities[record.row]         = last;
+                    records[get_index(last)].row = record.row;
+                    entities.pop_back();
+
+                    record.bucket = Record::NONE;
+                }
+
+                if (signature.empty()) return;
+
+                u32 bucket;
+                if (auto it = lookup.find(signature); it != lookup.end())
+                    bucket = it->second;
+                else
+                {
+                    bucket = (u32)buckets.size();
+                    buckets.push_back({signature});
+                    lookup.insert({signature, bucket});
+                }
+
+                record.bucket = bucket;
+                record.row    = (u32)buckets[bucket].entities.size();
+                buckets[bucket].entities.push_back(entity);
+            }
+
+            /**
+             * @brief Calls a function on every bucket that includes all
+             * component types in one mask and none of the types in another.
+             *
+             * @param include Component types a bucket must include.
+             * @param exclude Component types a bucket must not include.
+             * @param func Function called with each matching bucket.
+             */
+            template<typename Func>
+            void each(
+                const Signature& include, const Signature& exclude, Func func
+            )
+            {
+                for (auto& bucket : buckets)
+                {
+                    if (bucket.size() > 0 &&
+                        bucket.signature.contains(include) &&
+                        !bucket.signature.intersects(exclude))
+                        func(bucket);
+                }
+            }
+
+            /** @brief Empties every bucket and forgets all records. */
+            void reset()
+            {
+                for (auto& bucket : buckets) bucket.entities.clear();
+                records.clear();
+            }
+        };
+    }
+}
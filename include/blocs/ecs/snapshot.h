@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/entities/entitymanager.h>
+#include <blocs/ecs/components/component.h>
+#include <blocs/ecs/components/componentarray.h>
+
+namespace blocs
+{
+    namespace ecs
+    {
+        /**
+         * @brief Copy of a world's entities and components, taken with
+         * `World::snapshot` and applied with `World::restore`.
+         */
+        struct Snapshot
+        {
+            /** Entity allocator state, including entity names. */
+            EntityManager               entities;
+            /** One block per populated component array, ordered by type. */
+            std::vector<ComponentBlock> components;
+            /** Length of each owning group. */
+            std::vector<size>           groups;
+
+            /** @return Whether any block is delta encoded. */
+            bool is_delta() const
+            {
+                for (const auto& block : components)
+                {
+                    if (block.delta) return true;
+                }
+                return false;
+            }
+
+            /** @return Block of a component type, or nullptr if none. */
+            const ComponentBlock* find(Component type) const
+            {
+                for (const auto& block : components)
+                {
+                    if (block.type == type) return &block;
+                }
+                return nullptr;
+            }
+
+            /** @return Number of bytes held by the component blocks. */
+            size memory_usage() const
+            {
+                size total = 0;
+                for (const auto& block : components)
+                    total += block.bytes.capacity();
+                return total;
+            }
+        };
+
+        /** Shortest run of unchanged bytes that ends a literal run. */
+        constexpr size DELTA_MIN_RUN = 8;
+
+        /**
+         * @brief Encodes bytes as the difference from a base. The two are
+         * XOR'd so unchanged bytes become zero, then stored as a sequence of
+         * `[u32 zeros][u32 count][count literal bytes]` runs.
+         *
+         * @param base Bytes of the previous snapshot.
+         * @param bytes Bytes to encode.
+         *
+         * @return Encoded bytes.
+         */
+        inline std::vector<u8> delta_encode(
+            const std::vector<u8>& base, const std::vector<u8>& bytes
+        )
+        {
+            std::vector<u8> out;
+
+            size n  = bytes.size();
+            auto at = [&](size i) -> u8
+            { return bytes[i] ^ (i < base.size() ? base[i] : 0); };
+
+            auto write = [&](u32 value)
+            {
+                u8 raw[sizeof(u32)];
+                std::memcpy(raw, &value, sizeof(u32));
+                out.insert(out.end(), raw, raw + sizeof(u32));
+            };
+
+            size i = 0;
+            while (i < n)
+            {
+                u32 zeros = 0;
+                while (i < n && at(i) == 0)
+                {
+                    zeros++;
+                    i++;
+                }
+
+                // Extend the literal until a long enough zero run follows
+                size end = i, run = 0;
+                while (end + run < n && run < DELTA_MIN_RUN)
+                {
+                    if (at(end + run) == 0)
+                        run++;
+                    else
+                    {
+                        end += run + 1;
+                        run  = 0;
+                    }
+                }
+
+                write(zeros);
+                write(end - i);
+                for (; i < end; i++) out.push_back(at(i));
+            }
+
+            return out;
+        }
+
+        /**
+         * @brief Decodes bytes encoded by `delta_encode` against the same base.
+         *
+         * @param base Bytes the delta was encoded against.
+         * @param delta Encoded bytes.
+         *
+         * @return Decoded bytes.
+         */
+        inline std::vector<u8> delta_decode(
+            const std::vector<u8>& base, const std::vector<u8>& delta
+        )
+        {
+            std::vector<u8> out;
+
+            auto from = [&](size i) -> u8
+            { return i < base.size() ? base[i] : 0; };
+
+            auto read = [&](size& k)
+            {
+                u32 value;
+                std::memcpy(&value, delta.data() + k, sizeof(u32));
+                k += sizeof(u32);
+                return value;
+            };
+
+            size k = 0;
+            while (k < delta.size())
+            {
+                u32 zeros = read(k);
+                u32 count = read(k);
+
+                size start = out.size();
+                out.resize(start + zeros + count);
+                for (size i = start; i < start + zeros; i++) out[i] = from(i);
+
+                for (size i = start + zeros; i < out.size(); i++)
+                    out[i] = delta[k++] ^ from(i);
+            }
+
+            return out;
+        }
+    }
+}
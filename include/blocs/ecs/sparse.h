@@ -1,9 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <blocs/ecs/entities/entity.h>
+
 namespace blocs
 {
     namespace ecs
     {
+        /**
+         * @brief Sparse set of entities. Values are indexed by their entity
+         * index, and only the exact value (including its version) that was
+         * added is considered part of the set.
+         */
         template<typename T>
         struct sparse_set
         {
@@ -12,8 +23,17 @@ namespace blocs
                 "ERROR: type of sparse_set must be unsigned integer"
             );
 
-            T* sparse;
-            T* dense;
+            /** Number of sparse entries allocated together in one page. */
+            static constexpr size PAGE_SIZE = 4096;
+            /** Sparse value marking a value as not present in the set. */
+            static constexpr T    TOMBSTONE = std::numeric_limits<T>::max();
+
+            /**
+             * Pages of indices into the dense array, allocated the first time
+             * a value within the page's range is added.
+             */
+            std::vector<std::unique_ptr<T[]>> sparse;
+            std::vector<T>                    dense;
 
             size max = 0;
             size len = 0;
@@ -25,43 +45,62 @@ namespace blocs
                     "ERROR: cannot have a sparse set size smaller than 1"
                 );
                 max = size + 1;
-
-                sparse = new T[max];
-                dense  = new T[max];
-
-                for (i32 i = 0; i < max; i++)
-                {
-                    sparse[i] = max - 1U;
-                }
             }
 
-            ~sparse_set()
+            const T* begin() { return dense.data(); }
+            const T* end() { return dense.data() + len; }
+
+            T index(const T& val) const
             {
-                delete[] sparse;
-                delete[] dense;
+                EntityIndex i = get_index(val);
+                return sparse[i / PAGE_SIZE][i % PAGE_SIZE];
             }
+            T value(const T& val) const { return dense[index(val)]; }
+
+            bool empty() const { return len == 0; }
 
-            const T* begin() { return dense; }
-            const T* end() { return &dense[len]; }
+            /**
+             * @brief Replaces every value in the set, keeping the allocated
+             * sparse pages.
+             *
+             * @param values Values in dense order.
+             * @param count Number of values.
+             */
+            void assign(const T* values, size count)
+            {
+                for (size i = 0; i < len; i++)
+                {
+                    EntityIndex index = get_index(dense[i]);
+                    sparse[index / PAGE_SIZE][index % PAGE_SIZE] = TOMBSTONE;
+                }
 
-            T index(const T& val) const { return sparse[val]; }
-            T value(const T& val) const { return dense[sparse[val]]; }
+                dense.assign(values, values + count);
+                len = count;
+                for (size i = 0; i < count; i++) assure(values[i]) = i;
+            }
 
-            bool empty() const { return len == 0; }
+            /**
+             * @brief Grows the dense array to hold a number of values without
+             * reallocating.
+             */
+            void reserve(size count) { dense.reserve(count); }
             void clear()
             {
                 len = 0;
-                for (i32 i = 0; i < max; i++)
-                {
-                    sparse[i] = max - 1U;
-                }
+                dense.clear();
+                sparse.clear();
             }
 
             bool has(const T& val) const
             {
-                return (
-                    val < max && sparse[val] < len && sparse[val] != max - 1U
-                );
+                EntityIndex i    = get_index(val);
+                size        page = i / PAGE_SIZE;
+                if (i >= max || page >= sparse.size() ||
+                    sparse[page] == nullptr)
+                    return false;
+
+                T index = sparse[page][i % PAGE_SIZE];
+                return index != TOMBSTONE && dense[index] == val;
             }
 
             void add(const T& val)
@@ -69,12 +108,18 @@ namespace blocs
                 if (!has(val))
                 {
                     assert(
-                        val >= 0 && val < max &&
+                        get_index(val) < max &&
                         "ERROR: entity id exceeded sparse set range"
                     );
 
-                    dense[len]  = val;
-                    sparse[val] = len;
+                    T& slot = assure(val);
+                    assert(
+                        slot == TOMBSTONE &&
+                        "ERROR: another version of the entity is in the set"
+                    );
+
+                    slot = len;
+                    dense.push_back(val);
 
                     ++len;
                 }
@@ -84,14 +129,70 @@ namespace blocs
             {
                 if (has(val))
                 {
-                    dense[sparse[val]]     = dense[len - 1];
-                    sparse[dense[len - 1]] = sparse[val];
+                    T           i    = index(val);
+                    EntityIndex from = get_index(dense[len - 1]);
+                    EntityIndex to   = get_index(val);
 
-                    sparse[val] = max - 1U;
+                    dense[i]                                   = dense[len - 1];
+                    sparse[from / PAGE_SIZE][from % PAGE_SIZE] = i;
+                    sparse[to / PAGE_SIZE][to % PAGE_SIZE]     = TOMBSTONE;
 
+                    dense.pop_back();
                     --len;
                 }
             }
+
+            /**
+             * @brief Swaps two values in the dense array and updates their
+             * sparse entries.
+             *
+             * @param a Dense index of the first value.
+             * @param b Dense index of the second value.
+             */
+            void swap(size a, size b)
+            {
+                EntityIndex i = get_index(dense[a]);
+                EntityIndex j = get_index(dense[b]);
+
+                std::swap(dense[a], dense[b]);
+                sparse[i / PAGE_SIZE][i % PAGE_SIZE] = b;
+                sparse[j / PAGE_SIZE][j % PAGE_SIZE] = a;
+            }
+
+            /**
+             * @return Number of bytes allocated by the sparse pages and the
+             * dense array.
+             */
+            size memory_usage() const
+            {
+                size bytes = sparse.capacity() * sizeof(sparse[0]) +
+                             dense.capacity() * sizeof(T);
+                for (const auto& page : sparse)
+                {
+                    if (page != nullptr) bytes += PAGE_SIZE * sizeof(T);
+                }
+                return bytes;
+            }
+
+        private:
+            /**
+             * @brief Allocates the sparse page containing a value if it does
+             * not already exist.
+             *
+             * @return Reference to the sparse entry for the value.
+             */
+            T& assure(const T& val)
+            {
+                EntityIndex i    = get_index(val);
+                size        page = i / PAGE_SIZE;
+                if (page >= sparse.size()) sparse.resize(page + 1);
+                if (sparse[page] == nullptr)
+                {
+                    sparse[page] = std::make_unique<T[]>(PAGE_SIZE);
+                    std::fill_n(sparse[page].get(), PAGE_SIZE, TOMBSTONE);
+                }
+                return sparse[page][i % PAGE_SIZE];
+            }
         };
     }
 }
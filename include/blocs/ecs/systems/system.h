@@ -1,9 +1,12 @@
 #pragma once
 
 #include <functional>
+#include <typeindex>
+#include <vector>
 
 #include <blocs/platform/platform.h>
 #include <blocs/ecs/entities/entity.h>
+#include <blocs/ecs/queries/filter.h>
 
 namespace blocs
 {
@@ -12,16 +15,82 @@ namespace blocs
     {
         struct World;
 
+        /**
+         * Function called by a query with a reference to each queried
+         * component. Filters such as `Changed<T>` are not passed.
+         */
         template<typename T, typename... Types>
         using Query =
-            typename std::common_type<std::function<void(T&, Types&...)>>::type;
+            typename query_function<query_params<T, Types...>>::type;
         template<typename T, typename... Types>
-        using QueryWithEntity = typename std::common_type<
-            std::function<void(Entity, T&, Types&...)>>::type;
+        using QueryWithEntity =
+            typename query_function<query_params<T, Types...>>::with_entity;
 
         using SetupSystem    = std::function<void(World& world)>;
         using System         = std::function<void(World& world)>;
         using EventSystem    = std::function<void(World& world, Event event)>;
         using ShutdownSystem = std::function<void(World& world)>;
+
+        /**
+         * @brief Components and resources a system reads and writes. Systems
+         * in the same stage whose access does not conflict may run at the
+         * same time. A system without declared access is exclusive and runs
+         * alone, in the order it was added.
+         */
+        struct Access
+        {
+            std::vector<std::type_index> reads{};
+            std::vector<std::type_index> writes{};
+
+            bool exclusive = true;
+
+            /**
+             * @tparam Types components or resources only read by the system.
+             */
+            template<typename... Types>
+            Access& read()
+            {
+                (reads.push_back(typeid(Types)), ...);
+                exclusive = false;
+                return *this;
+            }
+
+            /**
+             * @tparam Types components or resources mutated by the system.
+             */
+            template<typename... Types>
+            Access& write()
+            {
+                (writes.push_back(typeid(Types)), ...);
+                exclusive = false;
+                return *this;
+            }
+
+            /**
+             * @return Whether two systems cannot run at the same time because
+             * one writes data the other reads or writes.
+             */
+            bool conflicts(const Access& other) const
+            {
+                if (exclusive || other.exclusive) return true;
+
+                auto overlaps = [](const std::vector<std::type_index>& a,
+                                   const std::vector<std::type_index>& b)
+                {
+                    for (const auto& type : a)
+                    {
+                        for (const auto& other : b)
+                        {
+                            if (type == other) return true;
+                        }
+                    }
+                    return false;
+                };
+
+                return overlaps(writes, other.reads) ||
+                       overlaps(writes, other.writes) ||
+                       overlaps(reads, other.writes);
+            }
+        };
     }
 }
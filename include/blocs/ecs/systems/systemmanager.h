@@ -4,6 +4,8 @@
 #include <vector>
 
 #include <blocs/common.h>
+#include <blocs/jobs.h>
+#include <blocs/ecs/components/componentmanager.h>
 #include <blocs/ecs/systems/system.h>
 
 namespace blocs
@@ -23,6 +25,23 @@ namespace blocs
             SHUTDOWN,
         };
 
+        /**
+         * @brief Dependency graph of the systems in a stage. Exclusive
+         * systems split the stage into batches, and a system depends on every
+         * earlier system in its batch whose access conflicts with its own.
+         */
+        struct Schedule
+        {
+            /** Systems that wait for each system to finish. */
+            std::vector<std::vector<u32>> dependents{};
+            /** Number of systems each system waits for. */
+            std::vector<u32>              dependencies{};
+
+            /** Whether any two systems are able to run at the same time. */
+            bool parallel = false;
+            bool dirty    = true;
+        };
+
         /**
          * @brief Manages systems registration, lookup by stage schedule,
          * and retrieval.
@@ -30,6 +49,10 @@ namespace blocs
         struct SystemManager
         {
             std::unordered_map<Stage, std::vector<System>> systems{};
+            std::unordered_map<Stage, std::vector<Access>> access{};
+            std::unordered_map<Stage, Schedule>            schedules{};
+            /** Tick each system last ran at. */
+            std::unordered_map<Stage, std::vector<Tick>>   ticks{};
 
             std::vector<SetupSystem>    setup_systems{};
             std::vector<EventSystem>    event_systems{};
@@ -43,8 +66,240 @@ namespace blocs
              * @param system System to add.
              */
             void add(Stage stage, System system)
+            {
+                add(stage, system, Access{});
+            }
+
+            /**
+             * @brief Registers a new system with the components and resources
+             * it reads and writes, allowing it to run in parallel with other
+             * systems of the stage it does not conflict with.
+             *
+             * @param stage Stage system will be scheduled to run during.
+             * @param system System to add.
+             * @param access Data the system reads and writes.
+             */
+            void add(Stage stage, System system, Access access)
             {
                 systems[stage].push_back(system);
+                this->access[stage].push_back(access);
+                ticks[stage].push_back(0);
+                schedules[stage].dirty = true;
+            }
+
+            /**
+             * @param stage Stage to get the dependency graph of.
+             *
+             * @return Dependency graph of the stage's systems, rebuilt if
+             * systems were added since it was last built.
+             */
+            Schedule& get_schedule(Stage stage)
+            {
+                Schedule& schedule = schedules[stage];
+                if (!schedule.dirty) return schedule;
+
+                auto& stage_access = access[stage];
+                u32   count        = (u32)stage_access.size();
+
+                schedule.dependents.assign(count, {});
+                schedule.dependencies.assign(count, 0);
+                schedule.parallel = false;
+
+                // Exclusive systems run alone, so batches never depend on
+                // systems before the last exclusive one
+                u32 batch = 0;
+                for (u32 i = 0; i < count; i++)
+                {
+                    if (stage_access[i].exclusive)
+                    {
+                        batch = i + 1;
+                        continue;
+                    }
+
+                    for (u32 j = batch; j < i; j++)
+                    {
+                        if (stage_access[i].conflicts(stage_access[j]))
+                        {
+                            schedule.dependents[j].push_back(i);
+                            schedule.dependencies[i]++;
+                        }
+                        else
+                            schedule.parallel = true;
+                    }
+                }
+
+                schedule.dirty = false;
+                return schedule;
+            }
+
+            /**
+             * @brief Runs a system at a newly advanced tick. `Changed` and
+             * `Added` filters in the system match every change made since it
+             * last ran, including changes made by later systems of its stage.
+             *
+             * @param system System to run.
+             * @param last Tick the system last ran at, updated to the tick it
+             * runs at.
+             */
+            static void run_system(
+                System& system, Tick& last, World& world,
+                ComponentManager& components
+            )
+            {
+                Tick tick = components.advance_tick();
+                {
+                    ComponentManager::SystemScope scope(components, tick, last);
+                    system(world);
+                }
+                last = tick;
+            }
+
+            /**
+             * @brief Runs a batch of systems with no exclusive systems among
+             * them, starting each on the job system once the systems it
+             * depends on have finished.
+             *
+             * @param begin Index of the first system of the batch.
+             * @param end Index after the last system of the batch.
+             */
+            void run_batch(
+                Stage stage, u32 begin, u32 end, World& world,
+                ComponentManager& components, JobSystem& jobs
+            )
+            {
+                auto&     stage_systems = systems[stage];
+                auto&     stage_ticks   = ticks[stage];
+                Schedule& schedule      = schedules[stage];
+
+                if (end - begin == 1)
+                {
+                    run_system(
+                        stage_systems[begin], stage_ticks[begin], world,
+                        components
+                    );
+                    return;
+                }
+
+                u32  count   = end - begin;
+                auto pending = std::make_unique<std::atomic<u32>[]>(count);
+                for (u32 i = begin; i < end; i++)
+                    pending[i - begin] = schedule.dependencies[i];
+
+                std::atomic<size>        remaining{count};
+                std::function<void(u32)> launch = [&](u32 i)
+                {
+                    jobs.submit(
+                        [&, i]()
+                        {
+                            run_system(
+                                stage_systems[i], stage_ticks[i], world,
+                                components
+                            );
+
+                            for (u32 dependent : schedule.dependents[i])
+                            {
+                                if (--pending[dependent - begin] == 0)
+                                    launch(dependent);
+                            }
+                            --remaining;
+                        }
+                    );
+                };
+
+                for (u32 i = begin; i < end; i++)
+                {
+                    if (schedule.dependencies[i] == 0) launch(i);
+                }
+
+                jobs.wait(remaining);
+            }
+
+            /**
+             * @brief Runs every system of a stage. Exclusive systems run on
+             * the calling thread once every earlier system has finished.
+             * Between them, systems that do not conflict are run at the same
+             * time on the job system, otherwise systems run in the order they
+             * were added.
+             *
+             * @param stage Stage to run.
+             * @param world World passed to each system.
+             * @param components Component manager of the world, which
+             * records the tick each system runs at.
+             * @param jobs Job system to run systems on.
+             */
+            void run(
+                Stage stage, World& world, ComponentManager& components,
+                JobSystem& jobs
+            )
+            {
+                auto& stage_systems = systems[stage];
+                if (stage_systems.empty()) return;
+
+                Schedule& schedule = get_schedule(stage);
+                if (!schedule.parallel || jobs.workers() == 0)
+                {
+                    run_local(stage, world, components);
+                    return;
+                }
+
+                auto& stage_access = access[stage];
+                auto& stage_ticks  = ticks[stage];
+                u32   count        = (u32)stage_systems.size();
+
+                u32 begin = 0;
+                while (begin < count)
+                {
+                    if (stage_access[begin].exclusive)
+                    {
+                        run_system(
+                            stage_systems[begin], stage_ticks[begin], world,
+                            components
+                        );
+                        begin++;
+                        continue;
+                    }
+
+                    u32 end = begin + 1;
+                    while (end < count && !stage_access[end].exclusive) end++;
+
+                    run_batch(stage, begin, end, world, components, jobs);
+                    begin = end;
+                }
+            }
+
+            /**
+             * @brief Runs every system of a stage on the calling thread, in
+             * the order they were added.
+             *
+             * @param stage Stage to run.
+             * @param world World passed to each system.
+             * @param components Component manager of the world.
+             */
+            void run_local(
+                Stage stage, World& world, ComponentManager& components
+            )
+            {
+                auto& stage_systems = systems[stage];
+                auto& stage_ticks   = ticks[stage];
+                for (size i = 0; i < stage_systems.size(); i++)
+                {
+                    run_system(
+                        stage_systems[i], stage_ticks[i], world, components
+                    );
+                }
+            }
+
+            /**
+             * @brief Clamps the tick every system last ran at to `oldest`
+             * (see `ComponentManager::clamp_ticks`).
+             */
+            void clamp_ticks(Tick oldest)
+            {
+                for (auto& [stage, stage_ticks] : ticks)
+                {
+                    for (Tick& tick : stage_ticks)
+                        tick = clamp_tick(tick, oldest);
+                }
             }
 
             /**
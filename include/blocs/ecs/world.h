@@ -1,24 +1,56 @@
 #pragma once
 
+/**
+ * Most entities that can be alive at once. Entity storage grows as entities
+ * are spawned, so the limit costs nothing up front. Define before including
+ * the ECS to change it.
+ */
+#ifndef BLOCS_MAX_ENTITIES
+#define BLOCS_MAX_ENTITIES 0xFFFFFFFE
+#endif
+
 namespace blocs
 {
     namespace ecs
     {
-        constexpr u16 MAX_ENTITIES   = 65535;
+        constexpr u32 MAX_ENTITIES   = BLOCS_MAX_ENTITIES;
         constexpr u8  MAX_COMPONENTS = 255;
     }
 }
 
 #include <blocs/time.h>
+#include <blocs/jobs.h>
 #include <blocs/ecs/entities/entitymanager.h>
 #include <blocs/ecs/components/componentmanager.h>
 #include <blocs/ecs/systems/systemmanager.h>
 #include <blocs/ecs/resources/resourcemanager.h>
+#include <blocs/ecs/commands/commandbuffer.h>
+#include <blocs/ecs/queries/queryterm.h>
+#include <blocs/ecs/queries/cachedquery.h>
+#include <blocs/ecs/queries/chunk.h>
+#include <blocs/ecs/queries/group.h>
+#include <blocs/ecs/snapshot.h>
 
 namespace blocs
 {
     namespace ecs
     {
+        /** Specifies how a world organizes entities for queries. */
+        enum class Storage : uchar
+        {
+            /**
+             * Queries iterate the smallest queried component array and check
+             * the others for every entity.
+             */
+            SPARSE_SET,
+            /**
+             * Entities are also indexed by component signature, and
+             * multi-component queries only visit the entities of signatures
+             * that match. Components stay in the per-type arrays either way.
+             */
+            SIGNATURE_INDEX,
+        };
+
         /**
          * @brief Maintains the Entity, Component, System, and Resource managers
          * and provides duplicate API's for common manager methods to allow
@@ -31,6 +63,44 @@ namespace blocs
             SystemManager    systems;
             ResourceManager  resources;
 
+            /** Worker threads used by parallel queries. */
+            JobSystem jobs;
+
+            /**
+             * Structural changes recorded by systems, applied after each
+             * stage.
+             */
+            Commands commands;
+
+            /**
+             * Tick each stage last ran at. `Changed` and `Added` filters in a
+             * stage's systems match components changed after it.
+             */
+            std::unordered_map<Stage, Tick> stage_ticks;
+
+            /** Tick recorded ticks were last clamped at. */
+            Tick clamped_tick = 0;
+
+            /**
+             * @param storage How entities are organized for queries.
+             * @param capacity Most entities that can be alive at once in this
+             * world, up to `MAX_ENTITIES`.
+             */
+            World(
+                Storage storage = Storage::SPARSE_SET,
+                size    capacity = ecs::MAX_ENTITIES
+            )
+            {
+                assert(
+                    capacity <= ecs::MAX_ENTITIES &&
+                    "ERROR: world capacity exceeds MAX_ENTITIES"
+                );
+                entities.capacity = capacity;
+
+                if (storage == Storage::SIGNATURE_INDEX)
+                    components.enable_signature_index();
+            }
+
             /**
              * @brief Creates a new entity from the available pool of id's and
              * adds to game. Will become available in System component queries
@@ -45,6 +115,18 @@ namespace blocs
 
             Entity spawn_entity() { return entities.create(); }
 
+            /**
+             * @brief Creates many anonymous entities at once.
+             *
+             * @param count Number of entities to create.
+             *
+             * @return The new entities.
+             */
+            std::vector<Entity> spawn_batch(size count)
+            {
+                return entities.create_batch(count);
+            }
+
             template<typename T, typename... Args>
             T& add_component(Entity entity, Args&&... args)
             {
@@ -60,7 +142,7 @@ namespace blocs
             void destroy_entity(Entity entity)
             {
                 entities.remove(entity);
-                components.remove(entity);
+                components.destroy(entity);
             }
 
             /**
@@ -78,16 +160,14 @@ namespace blocs
                 return component_array->set.len;
             }
 
-            template<typename T>
-            size query_count(std::function<bool(T&)> predicate)
+            template<typename T, typename Func>
+            size query_count(Func&& predicate)
             {
                 size  n               = 0;
                 auto* component_array = components.get_components<T>();
-                for (auto e = component_array->set.end();
-                     e-- != component_array->set.begin();)
+                for (auto i = component_array->size(); i-- > 0;)
                 {
-                    auto entity    = *e;
-                    auto component = component_array->get(entity);
+                    auto& component = component_array->at(i);
                     if (predicate(component))
                     {
                         n++;
@@ -98,51 +178,398 @@ namespace blocs
             }
 
             /**
-             * @brief Runs a lambda expression on every entity with components
-             * specified in the type parameters. The first type parameter
-             * specifies the "primary" component being queried whose component
-             * array is iterated over.
-             *
-             * @tparam Types the components to query for and use as params in
-             * the lambda.
-             * @param func Logic called on every entity that matches the query.
+             * @brief Calls a function on every entity within a range of a
+             * signature bucket, iterating backwards.
              */
-            template<typename T, typename... Types>
-            constexpr void query(Query<T, Types...> func)
+            template<typename T, typename... Types, typename Func>
+            void each_in(
+                SignatureBucket& bucket, size begin, size end, Func& func
+            )
+            {
+                for (auto i = end; i-- > begin;)
+                {
+                    auto entity = bucket.entities[i];
+                    if (!(QueryTerm<Types>::test(components, entity) && ...))
+                        continue;
+
+                    std::apply(
+                        func, std::tuple_cat(
+                                  std::tuple<Entity>(entity),
+                                  query_fetch<T, Types...>(components, entity)
+                              )
+                    );
+                }
+            }
+
+            /**
+             * @brief Calls a function on every entity within a range of an
+             * owning group that matches the query, iterating backwards.
+             * Components are fetched by index. The group's members are at the
+             * front of T's array, so only the range is read from it.
+             */
+            template<typename T, typename... Types, typename Func>
+            void each_in(
+                ComponentGroup&, const QueryMask& mask, size begin, size end,
+                Func& func
+            )
+            {
+                // Members own every required component, so only filters need
+                // checking
+                constexpr bool filtered = !(is_component_term<Types> && ...);
+
+                auto& entities = components.get_components<T>()->set.dense;
+                for (auto i = end; i-- > begin;)
+                {
+                    auto entity = entities[i];
+                    if (filtered &&
+                        !query_matches<Types...>(components, mask, entity))
+                        continue;
+
+                    std::apply(
+                        func,
+                        std::tuple_cat(
+                            std::tuple<Entity>(entity),
+                            query_fetch_at<T>(components, entity, i),
+                            query_fetch_at<Types>(components, entity, i)...
+                        )
+                    );
+                }
+            }
+
+            /**
+             * @brief Calls a function on every entity within a range of a
+             * component set that matches the query, iterating backwards.
+             */
+            template<typename T, typename... Types, typename Func>
+            void each_in(
+                sparse_set<Entity>* set, size begin, size end, Func& func
+            )
             {
                 auto* component_array = components.get_components<T>();
-                for (auto e = component_array->set.end();
-                     e-- != component_array->set.begin();)
+                auto  mask            = query_mask<T, Types...>(components);
+
+                if (set == &component_array->set)
                 {
-                    auto  entity    = *e;
-                    auto& component = component_array->get(entity);
+                    for (auto i = end; i-- > begin;)
+                    {
+                        auto entity = set->dense[i];
+
+                        constexpr i64 size = sizeof...(Types);
+                        if (size > 0 &&
+                            !query_matches<Types...>(components, mask, entity))
+                            continue;
+
+                        std::apply(
+                            func, std::tuple_cat(
+                                      std::tuple<Entity>(entity),
+                                      QueryTerm<T>::fetch_at(
+                                          components, *component_array, i
+                                      ),
+                                      query_fetch<Types...>(components, entity)
+                                  )
+                        );
+                    }
+                    return;
+                }
 
-                    constexpr i64 size = sizeof...(Types);
-                    if (size == 0 || components.has<Types...>(entity))
+                // Another component is rarer than T, so its entities drive the
+                // query and T is looked up instead.
+                for (auto i = end; i-- > begin;)
+                {
+                    auto entity = set->dense[i];
+                    if (!query_matches<Types...>(components, mask, entity))
+                        continue;
+
+                    std::apply(
+                        func, std::tuple_cat(
+                                  std::tuple<Entity>(entity),
+                                  query_fetch<T, Types...>(components, entity)
+                              )
+                    );
+                }
+            }
+
+            /**
+             * @brief Calls a function with the entity and components of every
+             * entity that matches the query. If an owning group owns exactly
+             * the required types, the front of its arrays is walked by index.
+             * Otherwise the smallest component array among the required types
+             * is iterated over and the other components are looked up for
+             * each of its entities. With `Storage::SIGNATURE_INDEX` only the
+             * entities of signatures that include every required type are
+             * iterated.
+             *
+             * @tparam Types the components and filters to query for.
+             * @param func Called with `(Entity, T&, Types&...)` on every
+             * matching entity, without the filters.
+             */
+            template<typename T, typename... Types, typename Func>
+            void each(Func&& func)
+            {
+                auto mask = query_mask<T, Types...>(components);
+                if (auto* group = components.get_group(mask.include))
+                {
+                    each_in<T, Types...>(*group, mask, 0, group->len, func);
+                    return;
+                }
+
+                if constexpr (sizeof...(Types) > 0)
+                {
+                    if (auto* index = components.get_signature_index())
                     {
-                        func(component, components.get<Types>(entity)...);
+                        index->each(
+                            mask.include, mask.exclude,
+                            [&](SignatureBucket& bucket)
+                            {
+                                each_in<T, Types...>(
+                                    bucket, 0, bucket.size(), func
+                                );
+                            }
+                        );
+                        return;
                     }
                 }
+
+                auto* set = query_smallest_set<T, Types...>(components);
+                each_in<T, Types...>(set, 0, set->len, func);
             }
 
-            template<typename T, typename... Types>
-            constexpr void query(QueryWithEntity<T, Types...> func)
+            /**
+             * @brief Parallel version of `World::each`. Splits the entities
+             * being iterated into chunks which are run on the world's job
+             * system. The function must not spawn or destroy entities or add
+             * or remove components.
+             *
+             * @tparam Types the components and filters to query for.
+             * @param func Called with `(Entity, T&, Types&...)` on every
+             * matching entity, from any worker thread.
+             * @param chunk_size Number of entities handed to a job at once.
+             */
+            template<typename T, typename... Types, typename Func>
+            void par_each(Func&& func, size chunk_size)
             {
-                auto* component_array = components.get_components<T>();
-                for (auto e = component_array->set.end();
-                     e-- != component_array->set.begin();)
+                // Registers every queried array before workers read them
+                auto* set  = query_smallest_set<T, Types...>(components);
+                auto  mask = query_mask<T, Types...>(components);
+
+                // Workers record and filter changes with the caller's ticks
+                Tick tick = components.tick();
+                Tick last = components.last_tick();
+
+                if (auto* group = components.get_group(mask.include))
                 {
-                    auto  entity    = *e;
-                    auto& component = component_array->get(entity);
+                    jobs.parallel_for(
+                        group->len, chunk_size,
+                        [&](size begin, size end)
+                        {
+                            ComponentManager::SystemScope scope(
+                                components, tick, last
+                            );
+                            each_in<T, Types...>(
+                                *group, mask, begin, end, func
+                            );
+                        }
+                    );
+                    return;
+                }
 
-                    constexpr i64 size = sizeof...(Types);
-                    if (size == 0 || components.has<Types...>(entity))
+                if constexpr (sizeof...(Types) > 0)
+                {
+                    if (auto* index = components.get_signature_index())
                     {
-                        func(
-                            entity, component, components.get<Types>(entity)...
+                        index->each(
+                            mask.include, mask.exclude,
+                            [&](SignatureBucket& bucket)
+                            {
+                                jobs.parallel_for(
+                                    bucket.size(), chunk_size,
+                                    [&](size begin, size end)
+                                    {
+                                        ComponentManager::SystemScope scope(
+                                            components, tick, last
+                                        );
+                                        each_in<T, Types...>(
+                                            bucket, begin, end, func
+                                        );
+                                    }
+                                );
+                            }
                         );
+                        return;
                     }
                 }
+
+                jobs.parallel_for(
+                    set->len, chunk_size,
+                    [&](size begin, size end)
+                    {
+                        ComponentManager::SystemScope scope(
+                            components, tick, last
+                        );
+                        each_in<T, Types...>(set, begin, end, func);
+                    }
+                );
+            }
+
+            /**
+             * @brief Calls a function with chunks of entities gathered from
+             * arrays that cannot be aligned. Components are copied into
+             * scratch columns, and the ones not queried as `const` are copied
+             * back (and marked as changed) after each chunk.
+             */
+            template<typename T, typename... Types, typename Func>
+            void gather_chunks(Func& func, size chunk_size)
+            {
+                auto* set  = query_smallest_set<T, Types...>(components);
+                auto  mask = query_mask<T, Types...>(components);
+
+                std::vector<Entity>       entities;
+                ChunkColumns<T, Types...> columns;
+
+                auto flush = [&]()
+                {
+                    func(columns.chunk(entities));
+                    columns.write_back(components, entities);
+                    entities.clear();
+                };
+
+                for (size i = 0; i < set->len; i++)
+                {
+                    Entity entity = set->dense[i];
+                    if (!mask.matches(components.get_signature(entity)))
+                        continue;
+
+                    entities.push_back(entity);
+                    columns.push(components, entity);
+                    if (entities.size() == chunk_size) flush();
+                }
+                if (!entities.empty()) flush();
+            }
+
+            /**
+             * @brief Calls a function with fixed-size chunks of the entities
+             * that own every queried component. The queried arrays are first
+             * aligned (see `ComponentManager::align`) so each chunk's
+             * components are contiguous. If an owning group owns some of the
+             * queried types but not exactly these, its arrays are left alone
+             * and each chunk's components are copied into scratch columns
+             * instead. Components not queried as `const` are marked as
+             * changed.
+             *
+             * @tparam Types the components to query for.
+             * @param func Called with a `Chunk<T, Types...>`.
+             * @param chunk_size Maximum number of entities per chunk.
+             */
+            template<typename T, typename... Types, typename Func>
+            void chunks(Func&& func, size chunk_size = CHUNK_SIZE)
+            {
+                if (chunk_size == 0) chunk_size = CHUNK_SIZE;
+                if (!components.can_align<T, Types...>())
+                {
+                    gather_chunks<T, Types...>(func, chunk_size);
+                    return;
+                }
+
+                size count = components.align<T, Types...>();
+
+                const Entity* entities =
+                    components.get_components<T>()->set.dense.data();
+                std::tuple<T*, Types*...> columns = {
+                    components.get_components<T>()->components.data(),
+                    components.get_components<Types>()->components.data()...};
+
+                QueryTerm<T>::mark_changed(components, 0, count);
+                (QueryTerm<Types>::mark_changed(components, 0, count), ...);
+
+                for (size begin = 0; begin < count; begin += chunk_size)
+                {
+                    size end = std::min(begin + chunk_size, count);
+
+                    func(Chunk<T, Types...>{
+                        entities + begin, end - begin,
+                        {std::get<T*>(columns) + begin,
+                         std::get<Types*>(columns) + begin...}});
+                }
+            }
+
+            /**
+             * @brief Runs a lambda expression on every entity with components
+             * specified in the type parameters. Iterates the smallest
+             * component array among the queried types (see `World::each`).
+             *
+             * @tparam Types the components to query for and use as params in
+             * the lambda, and filters (see `queries/filter.h`).
+             * @param func Logic called on every entity that matches the query,
+             * with or without the entity as its first parameter. Taken as a
+             * template parameter so it can be inlined into the loop.
+             */
+            template<typename T, typename... Types, typename Func>
+            constexpr void query(Func&& func)
+            {
+                each<T, Types...>(
+                    [&](Entity entity, auto&&... params)
+                    { query_invoke(func, entity, params...); }
+                );
+            }
+
+            /**
+             * @brief Runs a lambda expression on every entity with components
+             * specified in the type parameters, split across the world's job
+             * system (see `World::par_each`). Use `World::jobs` to change the
+             * number of worker threads.
+             *
+             * @tparam Types the components to query for and use as params in
+             * the lambda, and filters (see `queries/filter.h`).
+             * @param func Logic called on every entity that matches the query.
+             * @param chunk_size Number of entities handed to a job at once.
+             */
+            template<typename T, typename... Types, typename Func>
+            void par_query(
+                Func&& func, size chunk_size = JobSystem::DEFAULT_CHUNK_SIZE
+            )
+            {
+                par_each<T, Types...>(
+                    [&](Entity entity, auto&&... params)
+                    { query_invoke(func, entity, params...); },
+                    chunk_size
+                );
+            }
+
+            /**
+             * @brief Registers a persistent query whose matching entities are
+             * tracked as components are added and removed. Register once (e.g.
+             * in a setup system) and reuse the returned handle every frame.
+             *
+             * @tparam Types the components and filters to query for.
+             *
+             * @return Handle to the cached query.
+             */
+            template<typename T, typename... Types>
+            CachedQuery<T, Types...> register_query()
+            {
+                return {
+                    &components,
+                    components.register_cache(
+                        query_mask<T, Types...>(components)
+                    )};
+            }
+
+            /**
+             * @brief Creates an owning group for the component types, or
+             * returns the existing one. The group keeps the entities owning
+             * every type at the front of each type's array, and queries for
+             * exactly these types walk the arrays by index. A component type
+             * can only be owned by one group. Create groups before the hot
+             * loops run, such as in a setup system.
+             *
+             * @tparam Types the components owned by the group.
+             *
+             * @return Handle to the group.
+             */
+            template<typename T, typename... Types>
+            Group<T, Types...> group()
+            {
+                return {&components, components.register_group<T, Types...>()};
             }
 
             template<typename T>
@@ -156,40 +583,55 @@ namespace blocs
             template<typename T, typename... Types>
             struct QueryResult
             {
-                using item = std::tuple<Entity, T&, Types&...>;
+                using item = decltype(std::tuple_cat(
+                    std::declval<std::tuple<Entity>>(),
+                    std::declval<query_params<T, Types...>>()
+                ));
                 World* world;
 
                 struct Iterator
                 {
-                    World*             world;
-                    ComponentArray<T>* component_array;
+                    World*                                   world;
+                    ComponentArray<std::remove_const_t<T>>* component_array;
+                    /** Smallest queried set, whose entities are iterated. */
+                    sparse_set<Entity>* set;
 
-                    u16 index;
+                    size index;
 
                     item operator*()
                     {
-                        auto  entity = *(component_array->set.begin() + index);
-                        auto& component = component_array->get(entity);
-
-                        return {
-                            entity, component,
-                            world->components.get<Types>(entity)...};
+                        auto& components = world->components;
+                        auto  entity     = set->dense[index];
+                        return std::tuple_cat(
+                            std::tuple<Entity>(entity),
+                            set == &component_array->set
+                                ? QueryTerm<T>::fetch_at(
+                                      components, *component_array, index
+                                  )
+                                : QueryTerm<T>::fetch(components, entity),
+                            query_fetch<Types...>(components, entity)
+                        );
                     }
 
+                    /**
+                     * @return Whether the entity at the current index matches
+                     * the query.
+                     */
+                    bool matches() const
+                    {
+                        constexpr i64 size = sizeof...(Types);
+                        if (size == 0) return true;
+
+                        auto& components = world->components;
+                        return query_matches<T, Types...>(
+                            components, query_mask<T, Types...>(components),
+                            set->dense[index]
+                        );
+                    }
                     Iterator& operator++()
                     {
                         ++index;
-
-                        if constexpr (sizeof...(Types) > 0)
-                        {
-                            auto entity =
-                                *(component_array->set.begin() + index);
-                            while (index < component_array->set.len &&
-                                   !world->components.has<Types...>(entity))
-                            {
-                                ++index;
-                            }
-                        }
+                        while (index < set->len && !matches()) ++index;
 
                         return *this;
                     }
@@ -204,17 +646,7 @@ namespace blocs
                     Iterator& operator--()
                     {
                         --index;
-
-                        if constexpr (sizeof...(Types) > 0)
-                        {
-                            auto entity =
-                                *(component_array->set.begin() + index);
-                            while (index > 0 &&
-                                   !world->components.has<Types...>(entity))
-                            {
-                                --index;
-                            }
-                        }
+                        while (index > 0 && !matches()) --index;
 
                         return *this;
                     }
@@ -228,12 +660,12 @@ namespace blocs
 
                     Iterator operator+(const i32 val) const
                     {
-                        return {world, component_array, index + val};
+                        return {world, component_array, set, index + val};
                     }
 
                     Iterator operator-(const i32 val) const
                     {
-                        return {world, component_array, index - val};
+                        return {world, component_array, set, index - val};
                     }
 
                     bool operator==(const Iterator& i) const
@@ -249,32 +681,44 @@ namespace blocs
 
                 Iterator begin() const
                 {
-                    return {world, world->components.get_components<T>(), 0U};
+                    auto&    components = world->components;
+                    Iterator it         = {
+                        world, components.get_components<T>(),
+                        query_smallest_set<T, Types...>(components), 0};
+                    while (it.index < it.set->len && !it.matches()) ++it.index;
+
+                    return it;
                 }
 
                 Iterator end() const
                 {
+                    auto* set =
+                        query_smallest_set<T, Types...>(world->components);
                     return {
-                        world, world->components.get_components<T>(),
-                        (u16)world->components.get_components<T>()->set.len};
+                        world, world->components.get_components<T>(), set,
+                        set->len};
                 }
 
-                size size() const
+                /**
+                 * @return Number of entities in the smallest queried component
+                 * array (an upper bound on the number of matches).
+                 */
+                blocs::size size() const
                 {
-                    return world->components.get_components<T>()->set.len;
+                    return query_smallest_set<T, Types...>(world->components)
+                        ->len;
                 }
 
                 item operator[](i32 index)
                 {
-                    auto entity =
-                        *(world->components.get_components<T>()->set.begin() +
-                          index);
-                    auto& component =
-                        world->components.get_components<T>()->get(entity);
-
-                    return {
-                        entity, component,
-                        world->components.get<Types>(entity)...};
+                    auto* set =
+                        query_smallest_set<T, Types...>(world->components);
+
+                    auto entity = set->dense[index];
+                    return std::tuple_cat(
+                        std::tuple<Entity>(entity),
+                        query_fetch<T, Types...>(world->components, entity)
+                    );
                 }
             };
 
@@ -284,40 +728,177 @@ namespace blocs
                 return {this};
             }
 
+            /**
+             * @brief Applies the structural changes recorded in `commands`.
+             * Called automatically at the end of every stage.
+             */
+            void apply_commands() { commands.apply(entities, components); }
+
             void start()
             {
                 for (auto system : systems.setup_systems) system(*this);
+                apply_commands();
             }
 
             /**
-             * @brief Calls `reset` on the Entity and Component manager.
+             * @brief Calls `reset` on the Entity and Component manager and
+             * discards any pending commands.
              */
             void reset()
             {
+                commands.clear();
                 entities.reset();
                 components.reset();
             }
 
+            /**
+             * @brief Copies the entity allocator and every populated component
+             * array. Trivially copyable components are copied as raw bytes.
+             * Resources and pending commands are not included.
+             *
+             * @param base Optional full snapshot to delta encode against.
+             * Blocks that shrink are stored as the XOR of the base block, with
+             * unchanged runs compressed away, and need the same base to be
+             * restored.
+             *
+             * @return The snapshot.
+             */
+            Snapshot snapshot(const Snapshot* base = nullptr) const
+            {
+                assert(
+                    (!base || !base->is_delta()) &&
+                    "ERROR: Delta base must be a full snapshot"
+                );
+
+                Snapshot snapshot;
+                snapshot.entities = entities;
+                components.save(snapshot.components, snapshot.groups);
+
+                if (!base) return snapshot;
+
+                for (auto& block : snapshot.components)
+                {
+                    const ComponentBlock* from = base->find(block.type);
+                    if (!from) continue;
+
+                    std::vector<u8> delta =
+                        delta_encode(from->bytes, block.bytes);
+                    if (delta.size() < block.bytes.size())
+                    {
+                        block.bytes = std::move(delta);
+                        block.delta = true;
+                    }
+                }
+
+                return snapshot;
+            }
+
+            /**
+             * @brief Returns the world's entities and components to the state
+             * they were in when a snapshot was taken and discards any pending
+             * commands. Restored components are marked as changed at the
+             * current tick. Resources are left untouched.
+             *
+             * @param snapshot Snapshot taken from this world.
+             * @param base Full snapshot the snapshot was delta encoded
+             * against, if any.
+             */
+            void restore(
+                const Snapshot& snapshot, const Snapshot* base = nullptr
+            )
+            {
+                commands.clear();
+                entities = snapshot.entities;
+
+                if (!snapshot.is_delta())
+                {
+                    components.restore(snapshot.components, snapshot.groups);
+                    return;
+                }
+
+                assert(base && "ERROR: Delta snapshot restored without a base");
+
+                std::vector<ComponentBlock> blocks = snapshot.components;
+                for (auto& block : blocks)
+                {
+                    if (!block.delta) continue;
+
+                    const ComponentBlock* from = base->find(block.type);
+                    assert(from && "ERROR: Base is missing a delta block");
+
+                    block.bytes = delta_decode(from->bytes, block.bytes);
+                    block.delta = false;
+                }
+                components.restore(blocks, snapshot.groups);
+            }
+
             void events(Event& event)
             {
                 for (auto system : systems.event_systems) system(*this, event);
+                apply_commands();
             }
 
+            /**
+             * @brief Runs a stage, then applies the commands its systems
+             * recorded. Query filters in the stage's systems match the changes
+             * made since each system last ran, and elsewhere in the stage the
+             * changes made since the stage last ran.
+             *
+             * @param run Runs the systems of the stage.
+             */
+            template<typename Func>
+            void run_stage(Stage stage, Func&& run)
+            {
+                Tick& last = stage_ticks[stage];
+                components.set_last_tick(last);
+                last = components.tick();
+
+                run();
+
+                // Changes made from here on are new to the stage's next run
+                components.advance_tick();
+                apply_commands();
+
+                // Keeps old ticks comparable once the tick counter wraps
+                if (components.tick() - clamped_tick >= TICK_CHECK_INTERVAL)
+                {
+                    Tick oldest = components.clamp_ticks();
+                    systems.clamp_ticks(oldest);
+                    for (auto& entry : stage_ticks)
+                        entry.second = clamp_tick(entry.second, oldest);
+                    clamped_tick = components.tick();
+                }
+            }
+
+            /**
+             * @brief Runs the update stages in order. Within a stage, systems
+             * registered with non-conflicting `Access` run in parallel.
+             */
             void update()
             {
-                for (auto system : systems.systems[Stage::EARLY_UPDATE])
-                    system(*this);
-                for (auto system : systems.systems[Stage::UPDATE])
-                    system(*this);
-                for (auto system : systems.systems[Stage::LATE_UPDATE])
-                    system(*this);
+                for (auto stage :
+                     {Stage::EARLY_UPDATE, Stage::UPDATE, Stage::LATE_UPDATE})
+                {
+                    run_stage(
+                        stage,
+                        [&]() { systems.run(stage, *this, components, jobs); }
+                    );
+                }
             }
 
+            /**
+             * @brief Runs the draw stages in order on the calling thread, which
+             * owns the render context.
+             */
             void render()
             {
-                for (auto system : systems.systems[Stage::DRAW]) system(*this);
-
-                for (auto system : systems.systems[Stage::UI]) system(*this);
+                for (auto stage : {Stage::DRAW, Stage::UI})
+                {
+                    run_stage(
+                        stage,
+                        [&]() { systems.run_local(stage, *this, components); }
+                    );
+                }
             }
         };
     }
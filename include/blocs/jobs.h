@@ -0,0 +1,298 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <blocs/common.h>
+
+namespace blocs
+{
+    /**
+     * @brief Work-stealing thread pool. Every worker owns a queue of jobs and
+     * steals from the other queues when its own runs dry. Threads that wait
+     * on a batch of jobs help run them instead of blocking.
+     */
+    class JobSystem
+    {
+    public:
+        using Job = std::function<void()>;
+
+        /** Default number of items handed to a job by `parallel_for`. */
+        static constexpr size DEFAULT_CHUNK_SIZE = 1024;
+
+    private:
+        struct Queue
+        {
+            std::deque<Job> jobs;
+            std::mutex      mutex;
+        };
+
+        /**
+         * One queue per worker plus a shared queue (index 0) for jobs
+         * submitted from threads outside of the pool.
+         */
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread>            m_threads;
+
+        size              m_workers;
+        std::atomic<bool> m_running{false};
+        /** Held while the threads are started, so only one caller starts. */
+        std::mutex        m_startMutex;
+
+        std::atomic<size>       m_queued{0};
+        std::mutex              m_wakeMutex;
+        std::condition_variable m_wake;
+
+        /** Pool and queue owned by a worker thread. */
+        struct Worker
+        {
+            const JobSystem* pool  = nullptr;
+            size             queue = 0;
+        };
+
+        /** Pool the current thread works for, if any. */
+        static Worker& local_worker()
+        {
+            static thread_local Worker s_worker;
+            return s_worker;
+        }
+
+        /**
+         * @return Index of the queue owned by the current thread, or the
+         * shared queue if the thread is not one of this pool's workers.
+         */
+        size local_queue() const
+        {
+            const Worker& worker = local_worker();
+            return worker.pool == this ? worker.queue : 0;
+        }
+
+        /**
+         * @brief Creates the queues and worker threads unless another thread
+         * already has. Other threads only read the queues once they see
+         * `m_running` set.
+         */
+        void start()
+        {
+            std::lock_guard<std::mutex> lock(m_startMutex);
+            if (m_running) return;
+
+            m_queues.clear();
+            for (size i = 0; i <= m_workers; i++)
+                m_queues.push_back(std::make_unique<Queue>());
+
+            // Workers exit as soon as they see the pool stopped
+            m_running = true;
+
+            for (size i = 1; i <= m_workers; i++)
+            {
+                m_threads.emplace_back(
+                    [this, i]()
+                    {
+                        local_worker() = {this, i};
+                        work();
+                    }
+                );
+            }
+        }
+
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_running = false;
+            }
+            m_wake.notify_all();
+
+            for (auto& thread : m_threads) thread.join();
+            m_threads.clear();
+        }
+
+        void work()
+        {
+            Job job;
+            while (true)
+            {
+                if (pop(job))
+                {
+                    job();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(m_wakeMutex);
+                m_wake.wait(
+                    lock, [this]() { return !m_running || m_queued > 0; }
+                );
+                if (!m_running) return;
+            }
+        }
+
+        /**
+         * @brief Takes the newest job from the current thread's queue, or
+         * steals the oldest job from another queue.
+         *
+         * @return Whether a job was found.
+         */
+        bool pop(Job& job)
+        {
+            if (m_queued == 0) return false;
+
+            size own = local_queue();
+            {
+                auto& queue = *m_queues[own];
+
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.jobs.empty())
+                {
+                    job = std::move(queue.jobs.back());
+                    queue.jobs.pop_back();
+                    --m_queued;
+                    return true;
+                }
+            }
+
+            for (size i = 1; i <= m_queues.size(); i++)
+            {
+                auto& queue = *m_queues[(own + i) % m_queues.size()];
+
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.jobs.empty())
+                {
+                    job = std::move(queue.jobs.front());
+                    queue.jobs.pop_front();
+                    --m_queued;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    public:
+        /**
+         * @param workers Number of worker threads. Defaults to one less than
+         * the number of hardware threads, leaving a core for the calling
+         * thread which also runs jobs while it waits.
+         */
+        JobSystem(size workers = default_workers()) : m_workers(workers) {}
+
+        ~JobSystem()
+        {
+            if (m_running) stop();
+        }
+
+        JobSystem(const JobSystem&)            = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        static size default_workers()
+        {
+            size threads = std::thread::hardware_concurrency();
+            return threads > 1 ? threads - 1 : 0;
+        }
+
+        /** @return Number of worker threads. */
+        size workers() const { return m_workers; }
+
+        /**
+         * @brief Changes the number of worker threads. Must not be called
+         * while jobs are running.
+         *
+         * @param workers Number of worker threads (0 runs every job on the
+         * thread that waits for it).
+         */
+        void set_workers(size workers)
+        {
+            if (m_running) stop();
+            m_workers = workers;
+        }
+
+        /**
+         * @brief Queues a job on the current worker's queue (or the shared
+         * queue when called from outside the pool). Threads are started the
+         * first time a job is submitted, even if several threads submit
+         * their first jobs at once.
+         *
+         * @param job Job to run.
+         */
+        void submit(Job job)
+        {
+            if (!m_running) start();
+
+            {
+                auto& queue = *m_queues[local_queue()];
+
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.jobs.push_back(std::move(job));
+                ++m_queued;
+            }
+
+            // Acquire the lock so a worker about to sleep sees the new job
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+            }
+            m_wake.notify_one();
+        }
+
+        /**
+         * @brief Runs queued jobs on the current thread until a counter of
+         * remaining jobs reaches zero.
+         *
+         * @param remaining Counter decremented by each job of a batch.
+         */
+        void wait(const std::atomic<size>& remaining)
+        {
+            Job job;
+            while (remaining > 0)
+            {
+                if (pop(job))
+                    job();
+                else
+                    std::this_thread::yield();
+            }
+        }
+
+        /**
+         * @brief Splits the range [0, count) into chunks and runs them in
+         * parallel. Returns once every chunk has run.
+         *
+         * @param count Number of items.
+         * @param chunk_size Maximum number of items per job.
+         * @param func Called with the `[begin, end)` range of each chunk.
+         */
+        void parallel_for(
+            size count, size chunk_size,
+            const std::function<void(size begin, size end)>& func
+        )
+        {
+            if (count == 0) return;
+            if (chunk_size == 0) chunk_size = DEFAULT_CHUNK_SIZE;
+
+            // Nothing to split, so skip the queues entirely
+            if (m_workers == 0 || count <= chunk_size)
+            {
+                func(0, count);
+                return;
+            }
+
+            std::atomic<size> remaining{(count + chunk_size - 1) / chunk_size};
+            for (size begin = 0; begin < count; begin += chunk_size)
+            {
+                size end = std::min(begin + chunk_size, count);
+                submit(
+                    [&func, &remaining, begin, end]()
+                    {
+                        func(begin, end);
+                        --remaining;
+                    }
+                );
+            }
+
+            wait(remaining);
+        }
+    };
+}
@@ -39,36 +39,36 @@ namespace blocs
             mat4x4 m = mat4x4::identity;
 
             m[0][0] = mat[0][0] * (*this)[0][0] + mat[0][1] * (*this)[1][0] +
-                      mat[0][2] * (*this)[2][1] + mat[0][3] * (*this)[3][0];
+                      mat[0][2] * (*this)[2][0] + mat[0][3] * (*this)[3][0];
             m[0][1] = mat[0][0] * (*this)[0][1] + mat[0][1] * (*this)[1][1] +
-                      mat[0][2] * (*this)[2][2] + mat[0][3] * (*this)[3][1];
+                      mat[0][2] * (*this)[2][1] + mat[0][3] * (*this)[3][1];
             m[0][2] = mat[0][0] * (*this)[0][2] + mat[0][1] * (*this)[1][2] +
                       mat[0][2] * (*this)[2][2] + mat[0][3] * (*this)[3][2];
             m[0][3] = mat[0][0] * (*this)[0][3] + mat[0][1] * (*this)[1][3] +
                       mat[0][2] * (*this)[2][3] + mat[0][3] * (*this)[3][3];
 
             m[1][0] = mat[1][0] * (*this)[0][0] + mat[1][1] * (*this)[1][0] +
-                      mat[1][2] * (*this)[2][1] + mat[1][3] * (*this)[3][0];
+                      mat[1][2] * (*this)[2][0] + mat[1][3] * (*this)[3][0];
             m[1][1] = mat[1][0] * (*this)[0][1] + mat[1][1] * (*this)[1][1] +
-                      mat[1][2] * (*this)[2][2] + mat[1][3] * (*this)[3][1];
+                      mat[1][2] * (*this)[2][1] + mat[1][3] * (*this)[3][1];
             m[1][2] = mat[1][0] * (*this)[0][2] + mat[1][1] * (*this)[1][2] +
                       mat[1][2] * (*this)[2][2] + mat[1][3] * (*this)[3][2];
             m[1][3] = mat[1][0] * (*this)[0][3] + mat[1][1] * (*this)[1][3] +
                       mat[1][2] * (*this)[2][3] + mat[1][3] * (*this)[3][3];
 
             m[2][0] = mat[2][0] * (*this)[0][0] + mat[2][1] * (*this)[1][0] +
-                      mat[2][2] * (*this)[2][1] + mat[2][3] * (*this)[3][0];
+                      mat[2][2] * (*this)[2][0] + mat[2][3] * (*this)[3][0];
             m[2][1] = mat[2][0] * (*this)[0][1] + mat[2][1] * (*this)[1][1] +
-                      mat[2][2] * (*this)[2][2] + mat[2][3] * (*this)[3][1];
+                      mat[2][2] * (*this)[2][1] + mat[2][3] * (*this)[3][1];
             m[2][2] = mat[2][0] * (*this)[0][2] + mat[2][1] * (*this)[1][2] +
                       mat[2][2] * (*this)[2][2] + mat[2][3] * (*this)[3][2];
             m[2][3] = mat[2][0] * (*this)[0][3] + mat[2][1] * (*this)[1][3] +
                       mat[2][2] * (*this)[2][3] + mat[2][3] * (*this)[3][3];
 
             m[3][0] = mat[3][0] * (*this)[0][0] + mat[3][1] * (*this)[1][0] +
-                      mat[3][2] * (*this)[2][1] + mat[3][3] * (*this)[3][0];
+                      mat[3][2] * (*this)[2][0] + mat[3][3] * (*this)[3][0];
             m[3][1] = mat[3][0] * (*this)[0][1] + mat[3][1] * (*this)[1][1] +
-                      mat[3][2] * (*this)[2][2] + mat[3][3] * (*this)[3][1];
+                      mat[3][2] * (*this)[2][1] + mat[3][3] * (*this)[3][1];
             m[3][2] = mat[3][0] * (*this)[0][2] + mat[3][1] * (*this)[1][2] +
                       mat[3][2] * (*this)[2][2] + mat[3][3] * (*this)[3][2];
             m[3][3] = mat[3][0] * (*this)[0][3] + mat[3][1] * (*this)[1][3] +
@@ -79,58 +79,7 @@ namespace blocs
 
         constexpr mat4x4& operator*=(const mat4x4& mat)
         {
-            (*this)[0][0] =
-                mat[0][0] * (*this)[0][0] + mat[0][1] * (*this)[1][0] +
-                mat[0][2] * (*this)[2][1] + mat[0][3] * (*this)[3][0];
-            (*this)[0][1] =
-                mat[0][0] * (*this)[0][1] + mat[0][1] * (*this)[1][1] +
-                mat[0][2] * (*this)[2][2] + mat[0][3] * (*this)[3][1];
-            (*this)[0][2] =
-                mat[0][0] * (*this)[0][2] + mat[0][1] * (*this)[1][2] +
-                mat[0][2] * (*this)[2][2] + mat[0][3] * (*this)[3][2];
-            (*this)[0][3] =
-                mat[0][0] * (*this)[0][3] + mat[0][1] * (*this)[1][3] +
-                mat[0][2] * (*this)[2][3] + mat[0][3] * (*this)[3][3];
-
-            (*this)[1][0] =
-                mat[1][0] * (*this)[0][0] + mat[1][1] * (*this)[1][0] +
-                mat[1][2] * (*this)[2][1] + mat[1][3] * (*this)[3][0];
-            (*this)[1][1] =
-                mat[1][0] * (*this)[0][1] + mat[1][1] * (*this)[1][1] +
-                mat[1][2] * (*this)[2][2] + mat[1][3] * (*this)[3][1];
-            (*this)[1][2] =
-                mat[1][0] * (*this)[0][2] + mat[1][1] * (*this)[1][2] +
-                mat[1][2] * (*this)[2][2] + mat[1][3] * (*this)[3][2];
-            (*this)[1][3] =
-                mat[1][0] * (*this)[0][3] + mat[1][1] * (*this)[1][3] +
-                mat[1][2] * (*this)[2][3] + mat[1][3] * (*this)[3][3];
-
-            (*this)[2][0] =
-                mat[2][0] * (*this)[0][0] + mat[2][1] * (*this)[1][0] +
-                mat[2][2] * (*this)[2][1] + mat[2][3] * (*this)[3][0];
-            (*this)[2][1] =
-                mat[2][0] * (*this)[0][1] + mat[2][1] * (*this)[1][1] +
-                mat[2][2] * (*this)[2][2] + mat[2][3] * (*this)[3][1];
-            (*this)[2][2] =
-                mat[2][0] * (*this)[0][2] + mat[2][1] * (*this)[1][2] +
-                mat[2][2] * (*this)[2][2] + mat[2][3] * (*this)[3][2];
-            (*this)[2][3] =
-                mat[2][0] * (*this)[0][3] + mat[2][1] * (*this)[1][3] +
-                mat[2][2] * (*this)[2][3] + mat[2][3] * (*this)[3][3];
-
-            (*this)[3][0] =
-                mat[3][0] * (*this)[0][0] + mat[3][1] * (*this)[1][0] +
-                mat[3][2] * (*this)[2][1] + mat[3][3] * (*this)[3][0];
-            (*this)[3][1] =
-                mat[3][0] * (*this)[0][1] + mat[3][1] * (*this)[1][1] +
-                mat[3][2] * (*this)[2][2] + mat[3][3] * (*this)[3][1];
-            (*this)[3][2] =
-                mat[3][0] * (*this)[0][2] + mat[3][1] * (*this)[1][2] +
-                mat[3][2] * (*this)[2][2] + mat[3][3] * (*this)[3][2];
-            (*this)[3][3] =
-                mat[3][0] * (*this)[0][3] + mat[3][1] * (*this)[1][3] +
-                mat[3][2] * (*this)[2][3] + mat[3][3] * (*this)[3][3];
-
+            *this = *this * mat;
             return *this;
         }
 
@@ -1,6 +1,19 @@
 #pragma once
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <filesystem>
+#include <fstream>
 #include <vector>
 
 #include <blocs/common.h>
@@ -105,6 +118,113 @@ namespace blocs
             {
                 all_files_in_dir(list, path.c_str(), recursive);
             }
+
+            inline bool write_file(cstr path, const void* data, size len)
+            {
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                if (!file) return false;
+
+                file.write((const char*)data, len);
+                return (bool)file;
+            }
+
+            inline bool write_file(const str& path, const void* data, size len)
+            {
+                return write_file(path.c_str(), data, len);
+            }
+
+            /**
+             * @brief Read-only view of a file mapped into memory. The mapping
+             * is released when the view is destroyed.
+             */
+            class MappedFile
+            {
+            private:
+                const u8* m_data = nullptr;
+                size      m_len  = 0;
+#ifdef _WIN32
+                HANDLE m_file    = INVALID_HANDLE_VALUE;
+                HANDLE m_mapping = nullptr;
+#endif
+
+                void close()
+                {
+#ifdef _WIN32
+                    if (m_data) UnmapViewOfFile(m_data);
+                    if (m_mapping) CloseHandle(m_mapping);
+                    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+                    m_file    = INVALID_HANDLE_VALUE;
+                    m_mapping = nullptr;
+#else
+                    if (m_data) munmap((void*)m_data, m_len);
+#endif
+                    m_data = nullptr;
+                    m_len  = 0;
+                }
+
+            public:
+                MappedFile() = default;
+
+                /** @param path File to map. Check `is_open` for failure. */
+                MappedFile(const str& path)
+                {
+#ifdef _WIN32
+                    m_file = CreateFileA(
+                        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+                    );
+                    if (m_file == INVALID_HANDLE_VALUE) return;
+
+                    LARGE_INTEGER len;
+                    if (GetFileSizeEx(m_file, &len) && len.QuadPart > 0)
+                    {
+                        m_mapping = CreateFileMappingA(
+                            m_file, nullptr, PAGE_READONLY, 0, 0, nullptr
+                        );
+                    }
+                    if (m_mapping)
+                    {
+                        m_data = (const u8*)MapViewOfFile(
+                            m_mapping, FILE_MAP_READ, 0, 0, 0
+                        );
+                    }
+
+                    if (m_data)
+                        m_len = (size)len.QuadPart;
+                    else
+                        close();
+#else
+                    int file = open(path.c_str(), O_RDONLY);
+                    if (file < 0) return;
+
+                    struct stat info;
+                    if (fstat(file, &info) == 0 && info.st_size > 0)
+                    {
+                        void* data = mmap(
+                            nullptr, info.st_size, PROT_READ, MAP_PRIVATE,
+                            file, 0
+                        );
+                        if (data != MAP_FAILED)
+                        {
+                            m_data = (const u8*)data;
+                            m_len  = info.st_size;
+                        }
+                    }
+                    ::close(file);
+#endif
+                }
+
+                ~MappedFile() { close(); }
+
+                MappedFile(const MappedFile&)            = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                bool is_open() const { return m_data != nullptr; }
+
+                const u8* data() const { return m_data; }
+
+                size len() const { return m_len; }
+            };
         }
     }
 }
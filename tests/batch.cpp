@@ -0,0 +1,102 @@
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Tile
+{
+    i32 x, y;
+};
+
+struct Solid
+{
+};
+
+struct Label
+{
+    i32 value;
+};
+
+int main()
+{
+    World world;
+
+    Entity freed = world.spawn_entity();
+    world.destroy_entity(freed);
+
+    auto entities = world.spawn_batch(1000);
+
+    std::vector<Tile> tiles;
+    for (i32 i = 0; i < 1000; i++) tiles.push_back({i % 40, i / 40});
+    world.components.insert_batch<Tile>(entities, tiles);
+
+    bool alive = true;
+    bool match = true;
+    for (size i = 0; i < entities.size(); i++)
+    {
+        alive &= world.entities.alive(entities[i]);
+        match &= world.components.get<const Tile>(entities[i]).x == tiles[i].x;
+    }
+
+    // Half of the batch already owns the component
+    std::vector<Entity> mixed(entities.begin() + 500, entities.end());
+    for (i32 i = 0; i < 500; i++) mixed.push_back(world.spawn_entity());
+    std::vector<Tile> moved(mixed.size(), Tile{-1, -1});
+    world.components.insert_batch<Tile>(mixed, moved);
+
+    i32 overwritten = 0;
+    world.each<const Tile>(
+        [&](Entity, const Tile& tile) { overwritten += tile.x == -1; }
+    );
+
+    std::vector<Solid> none;
+    world.components.insert_batch<Solid>(entities, none);
+
+    // A repeated entity can't take the single copy path
+    Entity              first    = world.spawn_entity();
+    Entity              second   = world.spawn_entity();
+    std::vector<Entity> repeated = {first, second, first};
+    std::vector<Label>  labels   = {{1}, {2}, {3}};
+    world.components.insert_batch<Label>(repeated, labels);
+
+    auto* label_array = world.components.get_components<Label>();
+    bool  ordered     = label_array->set.len == 2 &&
+                   label_array->set.dense[0] == first &&
+                   label_array->set.dense[1] == second;
+
+    DESCRIBE(
+        "Batches",
+        {
+            EXPECT("spawn live entities", alive, true),
+            EXPECT(
+                "reuse freed indices first", get_index(entities[0]),
+                get_index(freed)
+            ),
+            EXPECT("insert components in order", match, true),
+            EXPECT(
+                "register every component", world.query_count<Tile>(),
+                (size)1500
+            ),
+            EXPECT("overwrite existing components", overwritten, 1000),
+            EXPECT(
+                "insert tags without values", world.query_count<Solid>(),
+                (size)1000
+            ),
+            EXPECT("store repeated entities once", ordered, true),
+            EXPECT(
+                "keep the last component of repeated entities",
+                world.components.get<const Label>(first).value, 3
+            ),
+            EXPECT(
+                "keep the components of other entities",
+                world.components.get<const Label>(second).value, 2
+            ),
+        }
+    );
+
+    return debug::test::failures();
+}
@@ -0,0 +1,204 @@
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/ecs/binary.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Player
+{
+    str              name;
+    std::vector<i32> items;
+};
+
+struct Solid
+{
+};
+
+SERIALIZE(Player, name, items)
+
+namespace game
+{
+    struct Position
+    {
+        f32 x, y;
+    };
+}
+
+namespace binary = serializer::binary;
+
+/** @return Header of a file. */
+binary::FileHeader* file_header(std::vector<u8>& bytes)
+{
+    return (binary::FileHeader*)bytes.data();
+}
+
+/** @return Entity slot of a file at an index. */
+Entity& file_slot(std::vector<u8>& bytes, u32 index)
+{
+    u64 offset = file_header(bytes)->slots_offset;
+    return ((Entity*)(bytes.data() + offset))[index];
+}
+
+/** @return Block header of the first block in a file. */
+binary::BlockHeader* first_block(std::vector<u8>& bytes)
+{
+    return (binary::BlockHeader*)(bytes.data() + sizeof(binary::FileHeader));
+}
+
+/** @return Whether corrupted bytes are rejected and leave the world as is. */
+bool rejects(std::vector<u8> bytes, World& world)
+{
+    size before = world.query_count<Position>();
+    bool loaded = binary::deserialize<Position, Player, Solid>(
+        world, bytes.data(), bytes.size()
+    );
+    return !loaded && world.query_count<Position>() == before;
+}
+
+int main()
+{
+    World  world;
+    Entity hero = world.spawn_entity("hero");
+    world.add_component<Position>(hero, 1.0f, 2.0f);
+    world.add_component<Player>(hero, Player{"hero", {3, 4}});
+    for (i32 i = 0; i < 50; i++)
+    {
+        Entity entity = world.spawn_entity();
+        world.add_component<Position>(entity, (f32)i, 0.0f);
+        if (i % 2 == 0) world.add_component<Solid>(entity);
+    }
+    world.destroy_entity(world.spawn_entity());
+
+    std::vector<u8> bytes = binary::serialize<Position, Player, Solid>(world);
+
+    World loaded;
+    bool  valid = binary::deserialize<Position, Player, Solid>(
+        loaded, bytes.data(), bytes.size()
+    );
+
+    Entity named  = loaded.entities.get_by_name("hero");
+    bool   placed = loaded.components.get<const Position>(hero).y == 2.0f;
+    auto&  player = loaded.components.get<const Player>(hero);
+    bool   fields = player.name == "hero" && player.items.size() == 2;
+
+    DESCRIBE(
+        "Binary files",
+        {
+            EXPECT("load what was written", valid, true),
+            EXPECT(
+                "restore raw components", loaded.query_count<Position>(),
+                (size)51
+            ),
+            EXPECT("restore component values", placed, true),
+            EXPECT("restore components field by field", fields, true),
+            EXPECT("restore tags", loaded.query_count<Solid>(), (size)25),
+            EXPECT("restore entity names", named, hero),
+            EXPECT(
+                "restore the free list", loaded.entities.free_list,
+                world.entities.free_list
+            ),
+        }
+    );
+
+    std::vector<u8> truncated(bytes.begin(), bytes.end() - 8);
+
+    std::vector<u8> overflow = bytes;
+    first_block(overflow)->count = ~u64(0) / sizeof(Entity) + 2;
+
+    std::vector<u8> past_end = bytes;
+    first_block(past_end)->data = ~u64(0) - 4;
+
+    std::vector<u8> stray = bytes;
+    u64             owner = first_block(stray)->entities;
+    *(Entity*)(stray.data() + owner) = make_entity(1000, 0);
+
+    std::vector<u8> broken = bytes;
+    first_block(broken)[1].bytes = 4;
+
+    std::vector<u8> repeated = bytes;
+    u64             listed   = first_block(repeated)->entities;
+    Entity*         members  = (Entity*)(repeated.data() + listed);
+    members[1]               = members[0];
+
+    u32 freed = file_header(bytes)->free_list;
+
+    std::vector<u8> past_slots = bytes;
+    file_slot(past_slots, freed) =
+        make_entity(file_header(bytes)->slots + 5, 0);
+
+    std::vector<u8> cycle = bytes;
+    file_slot(cycle, freed) = make_entity(freed, 0);
+
+    std::vector<u8> miscounted = bytes;
+    file_header(miscounted)->active--;
+
+    DESCRIBE(
+        "Binary files",
+        {
+            EXPECT("reject truncated data", rejects(truncated, loaded), true),
+            EXPECT(
+                "reject counts that overflow", rejects(overflow, loaded), true
+            ),
+            EXPECT(
+                "reject blocks past the end", rejects(past_end, loaded), true
+            ),
+            EXPECT(
+                "reject entities outside the file", rejects(stray, loaded),
+                true
+            ),
+            EXPECT(
+                "reject broken fields after valid blocks",
+                rejects(broken, loaded), true
+            ),
+            EXPECT(
+                "reject repeated entities in a block",
+                rejects(repeated, loaded), true
+            ),
+            EXPECT(
+                "reject free list links past the slots",
+                rejects(past_slots, loaded), true
+            ),
+            EXPECT("reject free list cycles", rejects(cycle, loaded), true),
+            EXPECT(
+                "reject miscounted entities", rejects(miscounted, loaded),
+                true
+            ),
+        }
+    );
+
+    DESCRIBE(
+        "Binary type ids",
+        {
+            EXPECT(
+                "trim the type name", serializer::type_name<Position>(),
+                std::string_view("Position")
+            ),
+            EXPECT(
+                "ignore const and references",
+                serializer::type_name<const Position&>(),
+                std::string_view("Position")
+            ),
+            EXPECT(
+                "keep namespaces", serializer::type_name<game::Position>(),
+                std::string_view("game::Position")
+            ),
+            EXPECT(
+                "differ between namespaces",
+                binary::type_id<Position>() ==
+                    binary::type_id<game::Position>(),
+                false
+            ),
+        }
+    );
+
+    return debug::test::failures();
+}
@@ -0,0 +1,108 @@
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Velocity
+{
+    f32 x, y;
+};
+
+int main()
+{
+    World  world;
+    Entity moving = world.spawn_entity();
+    world.add_component<Position>(moving, 0.0f, 0.0f);
+    world.add_component<Velocity>(moving, 1.0f, 0.0f);
+
+    for (i32 i = 0; i < 9; i++)
+        world.add_component<Position>(world.spawn_entity(), 0.0f, 0.0f);
+
+    i32 changed = 0;
+    i32 added   = 0;
+
+    // Runs before the system that moves entities
+    world.systems.add(
+        Stage::UPDATE,
+        [&](World& world)
+        {
+            changed = 0;
+            added   = 0;
+            world.each<const Position, Changed<Position>>(
+                [&](Entity, const Position&) { changed++; }
+            );
+            world.each<const Position, Added<Position>>(
+                [&](Entity, const Position&) { added++; }
+            );
+        }
+    );
+    world.systems.add(
+        Stage::UPDATE,
+        [](World& world)
+        {
+            world.each<Position, const Velocity>(
+                [](Entity, Position& position, const Velocity& velocity)
+                { position.x += velocity.x; }
+            );
+        }
+    );
+
+    world.update();
+    i32 first_changed = changed;
+    i32 first_added   = added;
+
+    Tick before = world.components.tick();
+    world.update();
+    i32 second_changed = changed;
+    i32 second_added   = added;
+
+    Tick position = world.components.get_components<Position>()
+                        ->changed_tick(moving);
+    Tick velocity = world.components.get_components<Velocity>()
+                        ->changed_tick(moving);
+
+    DESCRIBE(
+        "Change detection",
+        {
+            EXPECT("matches new components as changed", first_changed, 10),
+            EXPECT("matches new components as added", first_added, 10),
+            EXPECT(
+                "matches changes made later in the stage", second_changed, 1
+            ),
+            EXPECT("skips components added before", second_added, 0),
+            EXPECT(
+                "marks writes as changes", tick_newer(position, before), true
+            ),
+            EXPECT(
+                "skips reads through const", tick_newer(velocity, before),
+                false
+            ),
+        }
+    );
+
+    DESCRIBE(
+        "Tick wraparound",
+        {
+            EXPECT("orders ticks", tick_newer(5, 4), true),
+            EXPECT(
+                "orders ticks across the wrap", tick_newer(3, ~Tick(2)), true
+            ),
+            EXPECT("treats equal ticks as old", tick_newer(7, 7), false),
+            EXPECT("clamps old ticks", clamp_tick(10, 20), (Tick)20),
+            EXPECT("keeps new ticks", clamp_tick(30, 20), (Tick)30),
+            EXPECT(
+                "clamps ticks older than the wrap", clamp_tick(~Tick(0), 20),
+                (Tick)20
+            ),
+        }
+    );
+
+    return debug::test::failures();
+}
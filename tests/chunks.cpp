@@ -0,0 +1,107 @@
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Velocity
+{
+    f32 x, y;
+};
+
+struct Health
+{
+    i32 value;
+};
+
+/** @return Number of chunks, after moving every position by its velocity. */
+size step(World& world, size chunk_size)
+{
+    size count = 0;
+    world.chunks<Position, const Velocity>(
+        [&](Chunk<Position, const Velocity> chunk)
+        {
+            auto* positions  = chunk.get<Position>();
+            auto* velocities = chunk.get<const Velocity>();
+            for (size i = 0; i < chunk.count; i++)
+                positions[i].x += velocities[i].x;
+            count++;
+        },
+        chunk_size
+    );
+    return count;
+}
+
+/** @return Sum of the x position of every entity. */
+f32 total(World& world)
+{
+    f32 sum = 0;
+    world.each<const Position>(
+        [&](Entity, const Position& position) { sum += position.x; }
+    );
+    return sum;
+}
+
+int main()
+{
+    World world;
+    for (i32 i = 0; i < 1000; i++)
+    {
+        Entity entity = world.spawn_entity();
+        world.add_component<Position>(entity, 0.0f, 0.0f);
+        if (i % 2 == 0) world.add_component<Velocity>(entity, 1.0f, 0.0f);
+        if (i % 3 == 0) world.add_component<Health>(entity, 10);
+    }
+
+    size chunks = step(world, 100);
+    f32  moved  = total(world);
+
+    auto& components = world.components;
+    bool  aligned    = components.get_components<Position>()->set.dense[0] ==
+                   components.get_components<Velocity>()->set.dense[0];
+
+    DESCRIBE(
+        "Chunks",
+        {
+            EXPECT("split the matching entities", chunks, (size)5),
+            EXPECT("write through to the components", moved, 500.0f),
+            EXPECT("align the queried arrays", aligned, true),
+        }
+    );
+
+    // A group owning positions must keep its members at the front
+    auto group = world.group<Position, Health>();
+    size owned = group.size();
+
+    chunks = step(world, 128);
+    moved  = total(world);
+
+    i32  members = 0;
+    bool intact  = true;
+    group.each(
+        [&](Entity entity, Position&, Health&)
+        {
+            members++;
+            intact &= components.has<Health>(entity);
+        }
+    );
+
+    DESCRIBE(
+        "Chunks of group-owned arrays",
+        {
+            EXPECT("are gathered instead", chunks, (size)4),
+            EXPECT("write back to the components", moved, 1000.0f),
+            EXPECT("leave the group's length alone", group.size(), owned),
+            EXPECT("leave the group's members in place", members, 334),
+            EXPECT("leave the group's members intact", intact, true),
+        }
+    );
+
+    return debug::test::failures();
+}
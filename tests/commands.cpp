@@ -0,0 +1,97 @@
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Health
+{
+    i32 value;
+};
+
+struct Dead
+{
+};
+
+int main()
+{
+    World world;
+    world.jobs.set_workers(2);
+
+    for (i32 i = 0; i < 100; i++)
+        world.add_component<Health>(world.spawn_entity(), i % 2 ? 0 : 10);
+
+    // Destroying while iterating would move entities under the query
+    world.each<Health>(
+        [&](Entity entity, Health& health)
+        {
+            if (health.value == 0) world.commands.destroy(entity);
+        }
+    );
+    size recorded = world.query_count<Health>();
+    world.apply_commands();
+    size applied = world.query_count<Health>();
+
+    // Workers record commands at the same time
+    world.par_each<Health>(
+        [&](Entity entity, Health&) { world.commands.add<Dead>(entity); }, 4
+    );
+    world.apply_commands();
+    size tagged = world.query_count<Dead>();
+
+    auto   spawned  = world.commands.spawn().add<Health>(5);
+    Entity existing = world.spawn_entity();
+    world.commands.add<Health>(existing, 1);
+    world.commands.destroy(existing);
+    world.commands.destroy(existing);
+    world.apply_commands();
+
+    i32 created = 0;
+    world.each<Health, Without<Dead>>(
+        [&](Entity, Health& health) { created += health.value; }
+    );
+
+    // Commands queued for a destroyed entity must not reach the entity
+    // respawned in its slot
+    Entity stale = world.spawn_entity();
+    world.commands.add<Dead>(stale);
+    world.commands.remove<Health>(stale);
+    world.destroy_entity(stale);
+
+    Entity respawned = world.spawn_entity();
+    world.add_component<Health>(respawned, 3);
+    world.apply_commands();
+    world.add_component<Dead>(stale);
+
+    bool reused   = get_index(respawned) == get_index(stale);
+    bool kept     = world.components.has<Health>(respawned) &&
+                world.components.get<const Health>(respawned).value == 3;
+    bool untagged = !world.components.has<Dead>(respawned) &&
+                    world.query_count<Dead>() == tagged;
+
+    DESCRIBE(
+        "Commands",
+        {
+            EXPECT("wait to be applied", recorded, (size)100),
+            EXPECT("destroy entities when applied", applied, (size)50),
+            EXPECT("are recorded from worker threads", tagged, (size)50),
+            EXPECT("spawn entities with their components", created, 5),
+            EXPECT("track spawned entities", spawned.pending, true),
+            EXPECT(
+                "skip commands for entities destroyed in the batch",
+                world.components.has<Health>(existing), false
+            ),
+            EXPECT(
+                "ignore repeated destroys", world.entities.alive(existing),
+                false
+            ),
+            EXPECT("clear once applied", world.commands.empty(), true),
+            EXPECT("reuse the slot of destroyed entities", reused, true),
+            EXPECT("skip removes for stale handles", kept, true),
+            EXPECT("skip adds for stale handles", untagged, true),
+        }
+    );
+
+    return debug::test::failures();
+}
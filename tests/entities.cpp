@@ -0,0 +1,61 @@
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+int main()
+{
+    EntityManager entities;
+
+    Entity a = entities.create();
+    Entity b = entities.create();
+    entities.remove(a);
+    entities.remove(b);
+
+    // The most recently freed index is reused first
+    Entity c = entities.create();
+    Entity d = entities.create();
+
+    entities.remove(c);
+    Entity e = entities.create();
+
+    auto batch = entities.create_batch(3);
+
+    DESCRIBE(
+        "Versioned entity handles",
+        {
+            EXPECT("start new indices at version 0", get_version(a), (u32)0),
+            EXPECT("reuse freed indices", get_index(c), get_index(b)),
+            EXPECT(
+                "reuse indices last in, first out", get_index(d), get_index(a)
+            ),
+            EXPECT("bump the version on reuse", get_version(e), (u32)2),
+            EXPECT("detect stale handles", entities.alive(c), false),
+            EXPECT("keep reused handles alive", entities.alive(e), true),
+            EXPECT(
+                "append batches past the used indices", get_index(batch[0]),
+                (u32)2
+            ),
+            EXPECT(
+                "count active entities", entities.num_active_entities,
+                (size)5
+            ),
+        }
+    );
+
+    entities.reset();
+    Entity f = entities.create();
+
+    DESCRIBE(
+        "Entity reset",
+        {
+            EXPECT("drops every slot", entities.slots.size(), (size)1),
+            EXPECT("restarts indices at 0", get_index(f), (u32)0),
+            EXPECT("forgets handles from before", entities.alive(d), false),
+        }
+    );
+
+    return debug::test::failures();
+}
@@ -0,0 +1,92 @@
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Velocity
+{
+    f32 x, y;
+};
+
+struct Frozen
+{
+};
+
+/** @return Whether the group's members lead both arrays in the same order. */
+bool co_sorted(World& world, size len)
+{
+    auto& positions  = world.components.get_components<Position>()->set;
+    auto& velocities = world.components.get_components<Velocity>()->set;
+    for (size i = 0; i < len; i++)
+    {
+        if (positions.dense[i] != velocities.dense[i]) return false;
+    }
+    return true;
+}
+
+int main()
+{
+    World               world;
+    std::vector<Entity> entities;
+    for (i32 i = 0; i < 100; i++)
+    {
+        Entity entity = world.spawn_entity();
+        world.add_component<Position>(entity, (f32)i, 0.0f);
+        if (i % 4 == 0) world.add_component<Velocity>(entity, 1.0f, 0.0f);
+        entities.push_back(entity);
+    }
+
+    auto group   = world.group<Position, Velocity>();
+    size created = group.size();
+    bool sorted  = co_sorted(world, group.size());
+
+    world.add_component<Velocity>(entities[1], 1.0f, 0.0f);
+    size added = group.size();
+
+    world.remove_component<Velocity>(entities[0]);
+    world.destroy_entity(entities[4]);
+    size removed = group.size();
+    bool kept    = co_sorted(world, group.size());
+
+    i32 visited = 0;
+    world.each<Position, Velocity>(
+        [&](Entity, Position& position, Velocity& velocity)
+        {
+            position.x += velocity.x;
+            visited++;
+        }
+    );
+
+    world.add_component<Frozen>(entities[8]);
+    i32 filtered = 0;
+    world.each<Position, Velocity, Without<Frozen>>(
+        [&](Entity, Position&, Velocity&) { filtered++; }
+    );
+
+    bool same = world.group<Position, Velocity>().group == group.group;
+
+    DESCRIBE(
+        "Owning groups",
+        {
+            EXPECT("collect existing members", created, (size)25),
+            EXPECT("keep members at the front", sorted, true),
+            EXPECT("grow when a member is completed", added, (size)26),
+            EXPECT("shrink when members leave", removed, (size)24),
+            EXPECT("stay co-sorted after changes", kept, true),
+            EXPECT("drive matching queries", visited, 24),
+            EXPECT("apply query filters", filtered, 23),
+            EXPECT("are shared by queries of the same types", same, true),
+        }
+    );
+
+    return debug::test::failures();
+}
@@ -0,0 +1,102 @@
+#include <blocs/common.h>
+#include <blocs/math/matrix.h>
+#include <blocs/ecs/world.h>
+#include <blocs/ecs/hierarchy.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+/** @return Spawns an entity with both transforms. */
+Entity spawn_node(World& world, const mat4x4f& local)
+{
+    Entity entity = world.spawn_entity();
+    world.add_component<LocalTransform>(entity, local);
+    world.add_component<WorldTransform>(entity);
+    return entity;
+}
+
+/** @return X offset of an entity's world transform. */
+f32 world_x(World& world, Entity entity)
+{
+    return world.components.get<const WorldTransform>(entity).matrix[3][0];
+}
+
+int main()
+{
+    // The parent is applied after the child's own transform
+    mat4x4f scaled = mat4x4f::scale(2, 2, 1) * mat4x4f::translation(1, 0, 0);
+    mat4x4f moved  = mat4x4f::translation(1, 0, 0) * mat4x4f::scale(2, 2, 1);
+    vec3f   point  = vec3f(1, 0, 0) * moved;
+
+    DESCRIBE(
+        "Matrices",
+        {
+            EXPECT("scale the offsets of children", scaled[3][0], 2.0f),
+            EXPECT("keep offsets after a child scale", moved[3][0], 1.0f),
+            EXPECT("transform points", point.x, 3.0f),
+        }
+    );
+
+    World  world;
+    Entity root  = spawn_node(world, mat4x4f::translation(10, 0, 0));
+    Entity arm   = spawn_node(world, mat4x4f::translation(1, 0, 0));
+    Entity hand  = spawn_node(world, mat4x4f::translation(1, 0, 0));
+    Entity other = spawn_node(world, mat4x4f::identity);
+
+    bool linked = set_parent(world, arm, root) && set_parent(world, hand, arm);
+    propagate_transforms(world);
+    f32 hand_x = world_x(world, hand);
+
+    bool self_parent = set_parent(world, root, root);
+    bool cycle       = set_parent(world, root, hand);
+    bool untouched   = world.components.get<const Hierarchy>(root).parent ==
+                     NULL_ENTITY;
+
+    world.components.advance_tick();
+    world.components.get<LocalTransform>(root).matrix =
+        mat4x4f::translation(20, 0, 0);
+    propagate_transforms(world);
+    f32 moved_x = world_x(world, hand);
+
+    // Writing a world transform elsewhere doesn't hide local changes
+    world.components.advance_tick();
+    world.components.get<LocalTransform>(hand).matrix =
+        mat4x4f::translation(5, 0, 0);
+    world.components.advance_tick();
+    world.components.get<WorldTransform>(hand);
+    propagate_transforms(world);
+    f32 written_x = world_x(world, hand);
+
+    world.components.advance_tick();
+    set_parent(world, arm, other);
+    propagate_transforms(world);
+    f32 reparented_x = world_x(world, hand);
+
+    world.components.advance_tick();
+    remove_parent(world, arm);
+    propagate_transforms(world);
+    f32 detached_x = world_x(world, arm);
+
+    destroy_recursive(world, arm);
+
+    DESCRIBE(
+        "Hierarchies",
+        {
+            EXPECT("link parents and children", linked, true),
+            EXPECT("compose transforms down the tree", hand_x, 12.0f),
+            EXPECT("refuse to parent an entity to itself", self_parent, false),
+            EXPECT("refuse to form cycles", cycle, false),
+            EXPECT("leave links as they were when refused", untouched, true),
+            EXPECT("recompute subtrees of changed parents", moved_x, 22.0f),
+            EXPECT("ignore writes to world transforms", written_x, 26.0f),
+            EXPECT("recompute reparented subtrees", reparented_x, 6.0f),
+            EXPECT("recompute detached subtrees", detached_x, 1.0f),
+            EXPECT(
+                "destroy descendants", world.entities.alive(hand), false
+            ),
+        }
+    );
+
+    return debug::test::failures();
+}
@@ -0,0 +1,108 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/jobs.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+
+int main()
+{
+    {
+        JobSystem         jobs(4);
+        std::vector<u32>  hits(10000, 0);
+        std::atomic<size> calls{0};
+
+        jobs.parallel_for(
+            hits.size(), 64,
+            [&](size begin, size end)
+            {
+                for (size i = begin; i < end; i++) hits[i]++;
+                calls++;
+            }
+        );
+
+        bool once = true;
+        for (u32 hit : hits) once &= hit == 1;
+
+        DESCRIBE(
+            "Parallel for",
+            {
+                EXPECT("runs every item exactly once", once, true),
+                EXPECT("splits the range into chunks", (size)calls, (size)157),
+            }
+        );
+    }
+
+    {
+        JobSystem         outer(4);
+        JobSystem         inner(1);
+        std::atomic<size> started{0};
+        std::atomic<size> total{0};
+
+        // Every job waits for the others to start, so each runs on its own
+        // thread and workers of one pool submit to another
+        outer.parallel_for(
+            4, 1,
+            [&](size, size)
+            {
+                ++started;
+                while (started < 4) std::this_thread::yield();
+
+                inner.parallel_for(
+                    4096, 256,
+                    [&](size begin, size end) { total += end - begin; }
+                );
+            }
+        );
+
+        DESCRIBE(
+            "Nested job systems",
+            {
+                EXPECT(
+                    "runs jobs submitted from another pool's workers",
+                    (size)total, (size)(4 * 4096)
+                ),
+            }
+        );
+    }
+
+    {
+        JobSystem                jobs(2);
+        std::atomic<size>        ready{0};
+        std::atomic<size>        total{0};
+        std::vector<std::thread> threads;
+
+        // Threads outside the pool submit its first jobs at the same time
+        for (i32 i = 0; i < 4; i++)
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    ++ready;
+                    while (ready < 4) std::this_thread::yield();
+
+                    jobs.parallel_for(
+                        1024, 64,
+                        [&](size begin, size end) { total += end - begin; }
+                    );
+                }
+            );
+        }
+        for (auto& thread : threads) thread.join();
+
+        DESCRIBE(
+            "Job system startup",
+            {
+                EXPECT(
+                    "starts once when first used from several threads",
+                    (size)total, (size)(4 * 1024)
+                ),
+            }
+        );
+    }
+
+    return debug::test::failures();
+}
@@ -0,0 +1,108 @@
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Transform
+{
+    f32 x, y;
+};
+
+struct Boss
+{
+    i32 health;
+};
+
+int main()
+{
+    World  world;
+    Entity bosses[3];
+
+    for (i32 i = 0; i < 1000; i++)
+    {
+        Entity entity = world.spawn_entity();
+        world.add_component<Transform>(entity, (f32)i, 0.0f);
+        if (i % 400 == 0) bosses[i / 400] = entity;
+    }
+    for (i32 i = 0; i < 3; i++) world.add_component<Boss>(bosses[i], i);
+
+    // A boss with no transform never matches
+    world.add_component<Boss>(world.spawn_entity(), 99);
+
+    auto& components = world.components;
+    auto* smallest   = query_smallest_set<Transform, Boss>(components);
+
+    i32 visited = 0;
+    f32 x       = 0;
+    world.each<Transform, Boss>(
+        [&](Entity, Transform& transform, Boss&)
+        {
+            visited++;
+            x += transform.x;
+        }
+    );
+
+    i32 iterated = 0;
+    for (auto [entity, transform, boss] : world.iter<Transform, Boss>())
+        iterated += boss.health;
+
+    i32 without = 0;
+    world.each<Transform, Without<Boss>>(
+        [&](Entity, Transform&) { without++; }
+    );
+
+    DESCRIBE(
+        "Query driven by the smallest set",
+        {
+            EXPECT(
+                "picks the rarest component's set", smallest,
+                &components.get_components<Boss>()->set
+            ),
+            EXPECT(
+                "keeps the first type's set when it is smaller",
+                query_smallest_set<Boss>(components),
+                &components.get_components<Boss>()->set
+            ),
+            EXPECT("visits only matching entities", visited, 3),
+            EXPECT("fetches the first type by entity", x, 1200.0f),
+            EXPECT("iterates only matching entities", iterated, 3),
+            EXPECT("ignores sets of excluded types", without, 997),
+        }
+    );
+
+    World indexed{Storage::SIGNATURE_INDEX};
+    for (i32 i = 0; i < 1000; i++)
+    {
+        Entity entity = indexed.spawn_entity();
+        indexed.add_component<Transform>(entity, (f32)i, 0.0f);
+        if (i % 400 == 0) indexed.add_component<Boss>(entity, i);
+    }
+
+    i32 bucketed = 0;
+    indexed.each<Transform, Boss>(
+        [&](Entity, Transform&, Boss&) { bucketed++; }
+    );
+
+    // Moves the entity to the bucket without a boss
+    indexed.remove_component<Boss>(indexed.entities.slots[0]);
+    i32 moved = 0;
+    indexed.each<Transform, Boss>([&](Entity, Transform&, Boss&) { moved++; });
+
+    i32 unbossed = 0;
+    indexed.each<Transform, Without<Boss>>(
+        [&](Entity, Transform&) { unbossed++; }
+    );
+
+    DESCRIBE(
+        "Query driven by the signature index",
+        {
+            EXPECT("visits only matching entities", bucketed, 3),
+            EXPECT("follows entities between signatures", moved, 2),
+            EXPECT("skips signatures with excluded types", unbossed, 998),
+        }
+    );
+
+    return debug::test::failures();
+}
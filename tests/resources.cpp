@@ -0,0 +1,78 @@
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Clock
+{
+    f32 delta = 0;
+};
+
+/** Counts how many times it was destroyed. */
+template<i32 N>
+struct Tracked
+{
+    i32* destroyed;
+
+    ~Tracked() { (*destroyed)++; }
+};
+
+int main()
+{
+    i32        owned_destroyed    = 0;
+    i32        replaced_destroyed = 0;
+    i32        borrowed_destroyed = 0;
+    Tracked<2> borrowed{&borrowed_destroyed};
+
+    Clock outside{0.5f};
+    f32  cached      = 0;
+    f32  followed    = 0;
+    f32  after_reset = 1;
+    bool missing     = false;
+    {
+        World world;
+        auto  time = world.resources.ref<Clock>();
+        missing    = !time;
+
+        world.resources.add<Clock>(Clock{0.25f});
+        cached = time->delta;
+
+        world.resources.replace(&outside);
+        followed = time->delta;
+
+        world.resources.reset();
+        after_reset = time->delta;
+
+        world.resources.add<Tracked<0>>(&owned_destroyed);
+        world.resources.add<Tracked<1>>(&replaced_destroyed);
+        world.resources.replace((Tracked<1>*)nullptr);
+        world.resources.add(&borrowed);
+    }
+
+    DESCRIBE(
+        "Resources",
+        {
+            EXPECT("are missing until added", missing, true),
+            EXPECT("are read through cached pointers", cached, 0.25f),
+            EXPECT("are followed by cached pointers", followed, 0.5f),
+            EXPECT("reset to their default values", after_reset, 0.0f),
+            EXPECT("reset resources owned elsewhere", outside.delta, 0.0f),
+            EXPECT(
+                "are deleted with the world when it made them",
+                owned_destroyed, 1
+            ),
+            EXPECT(
+                "are deleted when replaced if the world made them",
+                replaced_destroyed, 1
+            ),
+            EXPECT(
+                "are left to their owner when passed in", borrowed_destroyed,
+                0
+            ),
+        }
+    );
+
+    return debug::test::failures();
+}
@@ -0,0 +1,113 @@
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/ecs/snapshot.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Velocity
+{
+    f32 x, y;
+};
+
+struct Name
+{
+    str value;
+};
+
+/** @return Sum of the x position of every entity. */
+f32 total(World& world)
+{
+    f32 sum = 0;
+    world.each<const Position>(
+        [&](Entity, const Position& position) { sum += position.x; }
+    );
+    return sum;
+}
+
+int main()
+{
+    World               world;
+    std::vector<Entity> entities;
+    for (i32 i = 0; i < 200; i++)
+    {
+        Entity entity = world.spawn_entity();
+        world.add_component<Position>(entity, 1.0f, 0.0f);
+        world.add_component<Velocity>(entity, 0.0f, 0.0f);
+        entities.push_back(entity);
+    }
+    world.add_component<Name>(entities[0], "player");
+
+    Snapshot keyframe = world.snapshot();
+
+    world.components.get<Position>(entities[7]).x = 5.0f;
+    world.components.get<Name>(entities[0]).value = "renamed";
+    world.destroy_entity(entities[9]);
+    Snapshot frame = world.snapshot(&keyframe);
+
+    // Diverge from both snapshots
+    world.destroy_entity(entities[3]);
+    world.add_component<Position>(world.spawn_entity(), 100.0f, 0.0f);
+
+    world.restore(frame, &keyframe);
+    f32  restored_frame = total(world);
+    str  frame_name     = world.components.get<Name>(entities[0]).value;
+    bool frame_alive    = world.entities.alive(entities[3]);
+
+    world.restore(keyframe);
+    f32  restored_keyframe = total(world);
+    bool keyframe_alive    = world.entities.alive(entities[9]);
+
+    DESCRIBE(
+        "Snapshots",
+        {
+            EXPECT("delta encode against a base", frame.is_delta(), true),
+            EXPECT(
+                "shrink when delta encoded",
+                frame.memory_usage() < keyframe.memory_usage(), true
+            ),
+            EXPECT("restore from a delta", restored_frame, 203.0f),
+            EXPECT("restore other components", frame_name, str("renamed")),
+            EXPECT("restore destroyed entities", frame_alive, true),
+            EXPECT("restore a full snapshot", restored_keyframe, 200.0f),
+            EXPECT("restore every entity", keyframe_alive, true),
+        }
+    );
+
+    // Restoring counts as a change for every restored component
+    Tick before = world.components.tick();
+    world.components.advance_tick();
+    world.restore(keyframe);
+    world.components.set_last_tick(before);
+
+    i32 changed = 0;
+    world.each<const Position, Changed<Position>>(
+        [&](Entity, const Position&) { changed++; }
+    );
+
+    // Component types missing from the world are skipped
+    World other;
+    other.add_component<Velocity>(other.spawn_entity(), 0.0f, 0.0f);
+    other.restore(keyframe);
+
+    DESCRIBE(
+        "Snapshot restore",
+        {
+            EXPECT("marks restored components changed", changed, 200),
+            EXPECT(
+                "skips component types never registered",
+                other.query_count<Velocity>(), (size)200
+            ),
+        }
+    );
+
+    return debug::test::failures();
+}
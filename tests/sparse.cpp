@@ -0,0 +1,105 @@
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+int main()
+{
+    {
+        sparse_set<Entity> set{ecs::MAX_ENTITIES};
+        bool               empty = set.sparse.empty();
+
+        set.add(make_entity(5000, 0));
+        set.add(make_entity(1, 0));
+        set.add(make_entity(2, 0));
+        set.remove(make_entity(1, 0));
+
+        DESCRIBE(
+            "Sparse set",
+            {
+                EXPECT("allocates no pages up front", empty, true),
+                EXPECT(
+                    "grows to the page of the largest index",
+                    set.sparse.size(), (size)2
+                ),
+                EXPECT("keeps values packed after a removal", set.len, (size)2),
+                EXPECT(
+                    "moves the last value into the hole", set.dense[1],
+                    make_entity(2, 0)
+                ),
+                EXPECT(
+                    "updates the moved value's index",
+                    set.index(make_entity(2, 0)), (Entity)1
+                ),
+                EXPECT(
+                    "drops removed values", set.has(make_entity(1, 0)), false
+                ),
+            }
+        );
+    }
+
+    {
+        sparse_set<Entity> set{ecs::MAX_ENTITIES};
+        set.add(make_entity(9000, 0));
+
+        DESCRIBE(
+            "Sparse set paging",
+            {
+                EXPECT(
+                    "skips pages below the first value",
+                    set.sparse[0] == nullptr, true
+                ),
+                EXPECT(
+                    "allocates the page of the value", set.sparse[2] != nullptr,
+                    true
+                ),
+                EXPECT(
+                    "reports values in unallocated pages as absent",
+                    set.has(make_entity(10, 0)), false
+                ),
+                EXPECT(
+                    "reports indices past the last page as absent",
+                    set.has(make_entity(90000, 0)), false
+                ),
+                EXPECT(
+                    "ignores other versions of a value",
+                    set.has(make_entity(9000, 1)), false
+                ),
+            }
+        );
+    }
+
+    {
+        ComponentArray<Position> array;
+        size                     before = array.components.capacity();
+
+        array.insert(make_entity(70000, 0), {1, 2});
+        array.insert(make_entity(3, 0), {3, 4});
+
+        DESCRIBE(
+            "Component storage",
+            {
+                EXPECT("allocates nothing up front", before, (size)0),
+                EXPECT(
+                    "grows with the components added", array.size(), (size)2
+                ),
+                EXPECT(
+                    "stores components densely", array.components[1].x, 3.0f
+                ),
+                EXPECT(
+                    "finds components by entity",
+                    array.get(make_entity(70000, 0)).y, 2.0f
+                ),
+            }
+        );
+    }
+
+    return debug::test::failures();
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/ecs/snapshot.h>
+#include <blocs/ecs/resources/spatialhash.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Body
+{
+    rectf rect;
+};
+
+rectf body_bounds(const Body& body) { return body.rect; }
+
+int main()
+{
+    World world;
+    auto* hash = world.resources.add<SpatialHash<Body>>(32.0f, &body_bounds);
+
+    // A 10 by 10 grid of 8 pixel bodies, 20 pixels apart
+    std::vector<Entity> grid;
+    for (i32 i = 0; i < 100; i++)
+    {
+        Entity entity = world.spawn_entity();
+        world.add_component<Body>(
+            entity, rectf((f32)(i % 10 * 20), (f32)(i / 10 * 20), 8, 8)
+        );
+        grid.push_back(entity);
+    }
+    hash->update(world);
+
+    size indexed = hash->count();
+    size corner  = hash->query(rectf(0, 0, 50, 50)).size();
+    size all     = hash->query(rectf(-100, -100, 1000, 1000)).size();
+    size circle  = hash->query(circlef(4, 4, 20)).size();
+
+    Entity closest;
+    bool   found   = hash->nearest(vec2f(101, 99), 50.0f, closest);
+    bool   too_far = hash->nearest(vec2f(-500, -500), 50.0f, closest);
+
+    size apart = hash->pairs().size();
+
+    // Moved next to its neighbour on the right
+    world.components.get<Body>(grid[0]).rect.x = 15;
+    world.remove_component<Body>(grid[99]);
+    hash->update(world);
+
+    auto touching = hash->pairs();
+    bool pair     = touching.size() == 1 &&
+                std::minmax(touching[0].first, touching[0].second) ==
+                    std::minmax(grid[0], grid[1]);
+
+    DESCRIBE(
+        "Spatial hash",
+        {
+            EXPECT("index every entity", indexed, (size)100),
+            EXPECT("query an area", corner, (size)9),
+            EXPECT("scan areas wider than the index", all, (size)100),
+            EXPECT("query a circle", circle, (size)3),
+            EXPECT("find the nearest entity", found, true),
+            EXPECT("return the nearest entity", closest, grid[55]),
+            EXPECT("ignore entities out of range", too_far, false),
+            EXPECT("report no pairs when apart", apart, (size)0),
+            EXPECT("rehash moved entities", pair, true),
+            EXPECT("drop removed components", hash->has(grid[99]), false),
+        }
+    );
+
+    Snapshot snapshot = world.snapshot();
+
+    world.components.advance_tick();
+    world.components.get<Body>(grid[0]).rect.x = 500;
+    hash->update(world);
+    f32 moved = hash->bounds(grid[0]).x;
+
+    world.components.advance_tick();
+    world.restore(snapshot);
+    hash->update(world);
+
+    DESCRIBE(
+        "Spatial hash",
+        {
+            EXPECT("follow later changes", moved, 500.0f),
+            EXPECT(
+                "pick up restored components", hash->bounds(grid[0]).x, 15.0f
+            ),
+            EXPECT("pick up restored pairs", hash->pairs().size(), (size)1),
+        }
+    );
+
+    return debug::test::failures();
+}
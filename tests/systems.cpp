@@ -0,0 +1,126 @@
+#include <atomic>
+#include <thread>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Position
+{
+    f32 x, y;
+};
+
+struct Velocity
+{
+    f32 x, y;
+};
+
+struct Rare
+{
+    i32 value;
+};
+
+/**
+ * @return Whether two reader systems, run in parallel on a fresh world,
+ * both query a component type no entity has ever owned.
+ */
+bool query_unregistered()
+{
+    World world;
+    world.jobs.set_workers(2);
+    world.add_component<Position>(world.spawn_entity(), 1.0f, 2.0f);
+
+    std::atomic<i32> found{0};
+    std::atomic<i32> queried{0};
+    std::atomic<i32> started{0};
+
+    auto reads_rare = Access{}.read<Position, Rare>();
+    auto reader     = [&](World& world)
+    {
+        // Wait for the other reader, so both query at the same time
+        started++;
+        for (i32 i = 0; i < 10000 && started < 2; i++)
+            std::this_thread::yield();
+
+        world.each<const Position, const Rare>(
+            [&](Entity, const Position&, const Rare&) { found++; }
+        );
+        queried++;
+    };
+    world.systems.add(Stage::UPDATE, reader, reads_rare);
+    world.systems.add(Stage::UPDATE, reader, reads_rare);
+    world.update();
+
+    return queried == 2 && found == 0;
+}
+
+int main()
+{
+    World world;
+    world.jobs.set_workers(2);
+
+    auto caller = std::this_thread::get_id();
+
+    std::atomic<i32> before{0};
+    i32              seen      = -1;
+    bool             on_caller = false;
+    bool             after     = false;
+
+    auto writes_position = Access{}.write<Position>();
+    auto writes_velocity = Access{}.write<Velocity>();
+
+    world.systems.add(
+        Stage::UPDATE, [&](World&) { before++; }, writes_position
+    );
+    world.systems.add(
+        Stage::UPDATE, [&](World&) { before++; }, writes_velocity
+    );
+    world.systems.add(
+        Stage::UPDATE,
+        [&](World&)
+        {
+            seen      = before;
+            on_caller = std::this_thread::get_id() == caller;
+        }
+    );
+    world.systems.add(
+        Stage::UPDATE, [&](World&) { after = seen == 2; }, writes_position
+    );
+
+    Schedule& schedule = world.systems.get_schedule(Stage::UPDATE);
+    world.update();
+
+    DESCRIBE(
+        "Exclusive systems",
+        {
+            EXPECT("run after every earlier system", seen, 2),
+            EXPECT("run on the calling thread", on_caller, true),
+            EXPECT("run before every later system", after, true),
+            EXPECT(
+                "leave the systems between them to run in parallel",
+                schedule.parallel, true
+            ),
+            EXPECT(
+                "leave later systems without earlier dependencies",
+                schedule.dependencies[3], (u32)0
+            ),
+        }
+    );
+
+    bool unregistered = true;
+    for (i32 i = 0; i < 64; i++) unregistered &= query_unregistered();
+
+    DESCRIBE(
+        "Parallel systems",
+        {
+            EXPECT(
+                "query component types nobody added", unregistered, true
+            ),
+        }
+    );
+
+    return debug::test::failures();
+}
@@ -0,0 +1,82 @@
+#include <thread>
+#include <vector>
+
+#include <blocs/common.h>
+#include <blocs/ecs/world.h>
+#include <blocs/debug/tests.h>
+
+using namespace blocs;
+using namespace blocs::ecs;
+
+struct Early
+{
+    i32 value;
+};
+
+struct Late
+{
+    i32 value;
+};
+
+struct Raced
+{
+    i32 value;
+};
+
+struct Position
+{
+    f32 x, y;
+};
+
+// Read during static initialization, in no particular order relative to
+// anything else
+static const u8 s_early = ComponentManager::get_type_id<Early>();
+
+int main()
+{
+    u8 late = ComponentManager::get_type_id<Late>();
+
+    // Threads asking for a new type at once get the same id
+    u8                       raced[4];
+    std::vector<std::thread> threads;
+    for (u8& id : raced)
+        threads.emplace_back(
+            [&id]() { id = ComponentManager::get_type_id<Raced>(); }
+        );
+    for (auto& thread : threads) thread.join();
+
+    bool agreed = raced[0] == raced[1] && raced[1] == raced[2] &&
+                  raced[2] == raced[3];
+    u8   next   = ComponentManager::get_type_id<Position>();
+
+    World  a;
+    World  b;
+    Entity entity = b.spawn_entity();
+    b.add_component<Late>(entity, 3);
+
+    DESCRIBE(
+        "Component type ids",
+        {
+            EXPECT(
+                "are stable from static initializers", s_early,
+                ComponentManager::get_type_id<Early>()
+            ),
+            EXPECT("differ between types", s_early != late, true),
+            EXPECT("are assigned once across threads", agreed, true),
+            EXPECT(
+                "are not used up by racing threads", next,
+                (u8)(raced[0] + 1)
+            ),
+            EXPECT(
+                "ignore const", ComponentManager::get_type_id<const Late>(),
+                late
+            ),
+            EXPECT(
+                "are shared by every world",
+                a.components.get_type_id<Late>(), late
+            ),
+        }
+    );
+
+    return debug::test::failures();
+}